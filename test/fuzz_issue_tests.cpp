@@ -8,9 +8,14 @@ SPDX-License-Identifier: BSD-3-Clause
 #include "test.hpp"
 #include "units/units.hpp"
 
+#include <atomic>
+#include <cmath>
 #include <cstring>
 #include <fstream>
 #include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
 
 using namespace units;
 TEST(fuzzFailures, convFailures)
@@ -102,6 +107,102 @@ TEST_P(slowProblems, slowFiles)
 
 INSTANTIATE_TEST_SUITE_P(slowFiles, slowProblems, ::testing::Range(1, 40));
 
+TEST(fuzzFailures, stepBudget)
+{
+    auto cdata = loadFailureFile("slow", 1);
+    ASSERT_FALSE(cdata.empty());
+
+    EXPECT_EQ(setParseStepBudget(32U), 0U);
+    EXPECT_EQ(getParseStepBudget(), 32U);
+    auto exhausted = getParseBudgetExhaustedCount();
+    auto limited = unit_from_string(cdata);
+    EXPECT_TRUE(is_error(limited));
+    EXPECT_EQ(getParseBudgetExhaustedCount(), exhausted + 1);
+    // the step count is deterministic
+    limited = unit_from_string(cdata);
+    EXPECT_TRUE(is_error(limited));
+    EXPECT_EQ(getParseBudgetExhaustedCount(), exhausted + 2);
+
+    auto meas = measurement_from_string("45 " + cdata);
+    EXPECT_TRUE(is_error(meas.units()));
+    EXPECT_TRUE(std::isnan(meas.value()));
+
+    // normal strings are well within a small budget
+    EXPECT_EQ(unit_from_string("kilogram meter per second squared"), N);
+    EXPECT_EQ(measurement_from_string("10 m/s"), 10.0 * m / s);
+    EXPECT_EQ(getParseBudgetExhaustedCount(), exhausted + 3);
+
+    setParseStepBudget(2U);
+    auto longUnit = unit_from_string("kilogram meter per second squared");
+    EXPECT_TRUE(is_error(longUnit));
+    EXPECT_EQ(getParseBudgetExhaustedCount(), exhausted + 4);
+
+    EXPECT_EQ(setParseStepBudget(0U), 2U);
+    EXPECT_EQ(unit_from_string("kilogram meter per second squared"), N);
+    EXPECT_TRUE(is_error(unit_from_string(cdata)));
+    EXPECT_EQ(getParseBudgetExhaustedCount(), exhausted + 4);
+}
+
+TEST(fuzzFailures, perCallStepBudget)
+{
+    auto cdata = loadFailureFile("slow", 1);
+    ASSERT_FALSE(cdata.empty());
+    ASSERT_EQ(getParseStepBudget(), 0U);
+
+    auto exhausted = getParseBudgetExhaustedCount();
+    auto limited = unit_from_chars(cdata.data(), cdata.size(), 0U, 32U);
+    EXPECT_TRUE(is_error(limited));
+    EXPECT_EQ(getParseBudgetExhaustedCount(), exhausted + 1);
+    // the default budget is not changed by a call with its own budget
+    EXPECT_EQ(getParseStepBudget(), 0U);
+
+    const std::string longName("kilogram meter per second squared");
+    EXPECT_TRUE(is_error(
+        unit_from_chars(longName.data(), longName.size(), 0U, 2U)));
+    EXPECT_EQ(unit_from_chars(longName.data(), longName.size()), N);
+    std::string meas("10 m/s");
+    EXPECT_TRUE(is_error(
+        measurement_from_chars(meas.data(), meas.size(), 0U, 1U).units()));
+    EXPECT_EQ(measurement_from_chars(meas.data(), meas.size()), 10.0 * m / s);
+
+    // a call's own budget replaces a tight default in both directions
+    setParseStepBudget(2U);
+    EXPECT_EQ(unit_from_chars(longName.data(), longName.size(), 0U, 0U), N);
+    EXPECT_TRUE(is_error(unit_from_string(longName)));
+    setParseStepBudget(0U);
+
+    // cached results do not bypass a call's own budget
+    enableParseCache();
+    EXPECT_EQ(unit_from_string(longName), N);
+    EXPECT_TRUE(is_error(
+        unit_from_chars(longName.data(), longName.size(), 0U, 2U)));
+    disableParseCache();
+
+    // threads converting with different budgets at the same time
+    std::atomic<int> failures{0};
+    std::vector<std::thread> threads;
+    for (int tt = 0; tt < 4; ++tt) {
+        threads.emplace_back([&failures, &cdata, &longName, tt]() {
+            for (int ii = 0; ii < 20; ++ii) {
+                if (tt % 2 == 0) {
+                    auto res =
+                        unit_from_chars(cdata.data(), cdata.size(), 0U, 16U);
+                    if (!is_error(res)) {
+                        ++failures;
+                    }
+                } else if (
+                    unit_from_chars(longName.data(), longName.size()) != N) {
+                    ++failures;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(failures.load(), 0);
+}
+
 class oomProblems : public ::testing::TestWithParam<int> {};
 
 TEST_P(oomProblems, oomFiles)
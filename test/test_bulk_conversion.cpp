@@ -0,0 +1,277 @@
+/*
+Copyright (c) 2019-2022,
+Lawrence Livermore National Security, LLC;
+See the top-level NOTICE for additional details. All rights reserved.
+SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#include "test.hpp"
+#include "units/units.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace units;
+
+namespace {
+std::vector<double> testValues()
+{
+    std::vector<double> vals{
+        0.0,
+        -0.0,
+        1.0,
+        -40.0,
+        32.0,
+        98.6,
+        273.15,
+        1e-310,
+        -1e300,
+        std::numeric_limits<double>::infinity(),
+        std::numeric_limits<double>::quiet_NaN()};
+    std::mt19937_64 gen(17);
+    std::uniform_real_distribution<double> dist(-1e4, 1e4);
+    // an odd length spanning several blocks leaves a tail for every width
+    while (vals.size() < 1237) {
+        vals.push_back(dist(gen));
+    }
+    return vals;
+}
+
+bool sameBits(double val1, double val2)
+{
+    if (std::isnan(val1) && std::isnan(val2)) {
+        return true;
+    }
+    std::uint64_t bits1;
+    std::uint64_t bits2;
+    std::memcpy(&bits1, &val1, sizeof(double));
+    std::memcpy(&bits2, &val2, sizeof(double));
+    return bits1 == bits2;
+}
+
+struct unit_pair {
+    precise_unit start;
+    precise_unit result;
+};
+
+const unit_pair kernelPairs[] = {
+    {precise::ft, precise::m},
+    {precise::mph, precise::m / precise::s},
+    {precise::electrical::kW, precise::hp},
+    {precise::degF, precise::degC},
+    {precise::degC, precise::degF},
+    {precise::K, precise::degF},
+    {precise::degF, precise::K},
+    {precise_unit(1e-3, precise::degC), precise::degF},
+    {precise::pressure::psig, precise::pressure::psi},
+    {precise::pressure::psi, precise::pressure::psig},
+    {precise::pressure::psig, precise::pressure::atm},
+    {precise::Hz, precise::ms},
+    {precise::min.inv(), precise::s},
+};
+}  // namespace
+
+TEST(bulkConversion, matchesScalar)
+{
+    auto vals = testValues();
+    std::vector<double> out(vals.size());
+    const unit_pair otherPairs[] = {
+        {precise::m, precise::m},
+        {precise::log::dB, precise::log::neper},
+        {precise::MW, precise::pu * precise::MW},
+        {precise::m, precise::kg},
+    };
+    std::vector<unit_pair> pairs(
+        std::begin(kernelPairs), std::end(kernelPairs));
+    pairs.insert(pairs.end(), std::begin(otherPairs), std::end(otherPairs));
+    for (const auto& pair : pairs) {
+        convert(vals.data(), out.data(), vals.size(), pair.start, pair.result);
+        for (std::size_t ii = 0; ii < vals.size(); ++ii) {
+            auto expected = convert(vals[ii], pair.start, pair.result);
+            ASSERT_TRUE(sameBits(out[ii], expected))
+                << to_string(pair.start) << " to " << to_string(pair.result)
+                << " value " << vals[ii];
+        }
+    }
+}
+
+TEST(bulkConversion, inPlace)
+{
+    auto vals = testValues();
+    auto converted = vals;
+    convert(
+        converted.data(),
+        converted.data(),
+        converted.size(),
+        precise::degF,
+        precise::degC);
+    for (std::size_t ii = 0; ii < vals.size(); ++ii) {
+        EXPECT_TRUE(sameBits(
+            converted[ii], convert(vals[ii], precise::degF, precise::degC)));
+    }
+#ifdef UNITS_HAS_SPAN
+    auto spanned = vals;
+    convert(std::span<double>(spanned), precise::degF, precise::degC);
+    EXPECT_EQ(spanned, converted);
+#endif
+}
+
+TEST(bulkConversion, floats)
+{
+    auto vals = testValues();
+    std::vector<float> fvals(vals.begin(), vals.end());
+    std::vector<float> out(fvals.size());
+    for (const auto& pair : kernelPairs) {
+        convert(
+            fvals.data(), out.data(), fvals.size(), pair.start, pair.result);
+        for (std::size_t ii = 0; ii < fvals.size(); ++ii) {
+            auto expected = static_cast<float>(convert(
+                static_cast<double>(fvals[ii]), pair.start, pair.result));
+            if (std::isnan(expected)) {
+                EXPECT_TRUE(std::isnan(out[ii]));
+            } else {
+                ASSERT_EQ(out[ii], expected);
+            }
+        }
+    }
+}
+
+#ifdef ENABLE_UNIT_TESTING
+TEST(bulkConversion, eachKernel)
+{
+    auto vals = testValues();
+    std::vector<double> out(vals.size());
+    for (int kernel = 0; kernel < 4; ++kernel) {
+        for (const auto& pair : kernelPairs) {
+            bool ran = detail::testing::testBulkKernel(
+                kernel,
+                vals.data(),
+                out.data(),
+                vals.size(),
+                pair.start,
+                pair.result);
+            if (kernel == 0) {
+                // every pair should resolve to a kernel conversion
+                ASSERT_TRUE(ran) << to_string(pair.start);
+            } else if (!ran) {
+                // the processor does not support this kernel
+                break;
+            }
+            for (std::size_t ii = 0; ii < vals.size(); ++ii) {
+                auto expected = convert(vals[ii], pair.start, pair.result);
+                ASSERT_TRUE(sameBits(out[ii], expected))
+                    << "kernel " << kernel << ' ' << to_string(pair.start);
+            }
+        }
+    }
+}
+#endif
+
+TEST(bulkEquationConversion, strictMatchesScalar)
+{
+    using precise::equations::eq_accuracy;
+    auto vals = testValues();
+    for (auto& val : vals) {
+        val /= 100.0;
+    }
+    std::vector<double> out(vals.size());
+    for (std::uint32_t eq = 0; eq < 32; ++eq) {
+        const precise_unit equnits[] = {
+            precise_unit(precise::custom::equation_unit(eq)),
+            precise_unit(precise::custom::equation_unit(eq)) * precise::W};
+        for (const auto& equnit : equnits) {
+            auto base = equnit.base_units();
+            precise::equations::convert_equnit_to_value(
+                vals.data(), out.data(), vals.size(), base);
+            for (std::size_t ii = 0; ii < vals.size(); ++ii) {
+                ASSERT_TRUE(sameBits(
+                    out[ii],
+                    precise::equations::convert_equnit_to_value(
+                        vals[ii], base)))
+                    << "equation type " << eq;
+            }
+            precise::equations::convert_value_to_equnit(
+                vals.data(),
+                out.data(),
+                vals.size(),
+                base,
+                eq_accuracy::strict);
+            for (std::size_t ii = 0; ii < vals.size(); ++ii) {
+                ASSERT_TRUE(sameBits(
+                    out[ii],
+                    precise::equations::convert_value_to_equnit(
+                        vals[ii], base)))
+                    << "equation type " << eq;
+            }
+        }
+    }
+}
+
+TEST(bulkEquationConversion, fastBounds)
+{
+    using precise::equations::eq_accuracy;
+    std::mt19937_64 gen(29);
+    std::uniform_real_distribution<double> dist(-300.0, 300.0);
+    std::vector<double> vals(1001);
+    for (auto& val : vals) {
+        val = dist(gen);
+    }
+    vals[0] = std::numeric_limits<double>::quiet_NaN();
+    vals[1] = std::numeric_limits<double>::infinity();
+    vals[2] = -std::numeric_limits<double>::infinity();
+    std::vector<double> linear(vals.size());
+    std::vector<double> fast(vals.size());
+    std::vector<double> back(vals.size());
+    const precise_unit equnits[] = {
+        precise::log::dB,
+        precise::log::dB * precise::W,
+        precise::log::neper,
+        precise::log::bel * precise::V,
+        precise::log::logbase2,
+        precise::log::neglog1000,
+        precise::special::moment_magnitude};
+    for (const auto& equnit : equnits) {
+        auto base = equnit.base_units();
+        precise::equations::convert_equnit_to_value(
+            vals.data(), linear.data(), vals.size(), base);
+        precise::equations::convert_equnit_to_value(
+            vals.data(), fast.data(), vals.size(), base, eq_accuracy::fast);
+        for (std::size_t ii = 0; ii < vals.size(); ++ii) {
+            if (std::isnan(linear[ii])) {
+                EXPECT_TRUE(std::isnan(fast[ii]));
+            } else if (std::isinf(linear[ii])) {
+                EXPECT_EQ(fast[ii], linear[ii]);
+            } else if (std::fabs(linear[ii]) < 1e-300) {
+                // very small results are flushed to zero
+                EXPECT_NEAR(fast[ii], linear[ii], 1e-300);
+            } else {
+                double bound =
+                    2e-16 * (2.0 + std::fabs(std::log2(linear[ii])));
+                EXPECT_LE(std::fabs(fast[ii] / linear[ii] - 1.0), bound)
+                    << to_string(equnit) << " " << vals[ii];
+            }
+        }
+
+        precise::equations::convert_value_to_equnit(
+            linear.data(), back.data(), linear.size(), base);
+        precise::equations::convert_value_to_equnit(
+            linear.data(),
+            fast.data(),
+            linear.size(),
+            base,
+            eq_accuracy::fast);
+        for (std::size_t ii = 0; ii < vals.size(); ++ii) {
+            if (std::isnan(back[ii]) || std::isinf(back[ii])) {
+                EXPECT_TRUE(sameBits(fast[ii], back[ii]));
+            } else {
+                // the magnitude scale offsets are at most 10.7
+                EXPECT_NEAR(
+                    fast[ii], back[ii], 6e-16 * (std::fabs(back[ii]) + 10.7));
+            }
+        }
+    }
+}
@@ -8,6 +8,9 @@ SPDX-License-Identifier: BSD-3-Clause
 #include "test.hpp"
 #include "units/units.hpp"
 
+#include <cmath>
+#include <vector>
+
 static const double neg_forty_C = -40.0;
 static const double neg_forty_C_in_F = -40.0;
 static const double neg_forty_C_in_K = 233.15;
@@ -706,3 +709,83 @@ TEST(UnitDefinitions, mass_to_weight)
 
     EXPECT_NEAR(convert(1.0, precise::lbf, kg), 0.45359237, test::tolerance);
 }
+
+TEST(converter, kinds)
+{
+    using namespace units;
+    using kind = converter::kind;
+    EXPECT_EQ(converter(precise::m, precise::m).type(), kind::identity);
+    EXPECT_EQ(converter(precise::m, precise::ft).type(), kind::linear);
+    EXPECT_EQ(converter(m, precise::ft).type(), kind::linear);
+    EXPECT_EQ(converter(precise::degF, precise::degC).type(), kind::affine);
+    EXPECT_EQ(converter(precise::K, precise::degF).type(), kind::affine);
+    EXPECT_EQ(
+        converter(precise::pressure::psig, precise::pressure::psi).type(),
+        kind::affine);
+    EXPECT_EQ(converter(precise::Hz, precise::s).type(), kind::inverse);
+    EXPECT_EQ(
+        converter(precise::log::dB, precise::log::bel).type(), kind::equation);
+    EXPECT_EQ(converter(precise::m, precise::kg).type(), kind::unconvertible);
+    EXPECT_FALSE(converter(precise::m, precise::kg).is_valid());
+    EXPECT_TRUE(std::isnan(converter(precise::m, precise::kg)(2.0)));
+
+    EXPECT_EQ(
+        converter(precise::pu * precise::MW, precise::MW, 100.0).type(),
+        kind::linear);
+    EXPECT_EQ(
+        converter(precise::pressure::atm, precise::pressure::psig, 14.8)
+            .type(),
+        kind::general);
+}
+
+TEST(converter, matchesConvert)
+{
+    using namespace units;
+    const double values[] = {-40.0, -1.5, 0.0, 0.25, 1.0, 37.0, 1e6};
+    auto check = [&values](
+                     const precise_unit& start, const precise_unit& result) {
+        converter conv(start, result);
+        for (auto val : values) {
+            auto expected = convert(val, start, result);
+            if (std::isnan(expected)) {
+                EXPECT_TRUE(std::isnan(conv(val)));
+            } else if (std::isinf(expected)) {
+                EXPECT_EQ(conv(val), expected);
+            } else {
+                EXPECT_NEAR(
+                    conv(val), expected, std::fabs(expected) * 1e-14 + 1e-12);
+            }
+        }
+    };
+    check(precise::m, precise::ft);
+    check(precise::mph, precise::m / precise::s);
+    check(precise::degF, precise::degC);
+    check(precise::degC, precise::degF);
+    check(precise::K, precise::degF);
+    check(precise_unit(1e-3, precise::degC), precise::degF);
+    check(precise::pressure::psig, precise::pressure::psi);
+    check(precise::pressure::psi, precise::pressure::psig);
+    check(precise::pressure::atm, precise::pressure::psig);
+    check(precise::Hz, precise::ms);
+    check(precise::log::dB, precise::log::bel);
+    check(precise::m, precise::kg);
+
+    converter conv(precise::in, precise::cm);
+    std::vector<double> vals(values, values + 7);
+    std::vector<double> out(vals.size());
+    conv.apply(vals.data(), out.data(), vals.size());
+    conv.apply(vals);
+    for (std::size_t ii = 0; ii < vals.size(); ++ii) {
+        EXPECT_EQ(out[ii], vals[ii]);
+        EXPECT_DOUBLE_EQ(out[ii], values[ii] * 2.54);
+    }
+
+    converter puconv(precise::MW, precise::pu * precise::MW, 100.0);
+    EXPECT_DOUBLE_EQ(
+        puconv(50.0),
+        convert(50.0, precise::MW, precise::pu * precise::MW, 100.0));
+    converter puconv2(precise::pu * precise::A, precise::A, 100.0, 10.0);
+    EXPECT_DOUBLE_EQ(
+        puconv2(0.5),
+        convert(0.5, precise::pu * precise::A, precise::A, 100.0, 10.0));
+}
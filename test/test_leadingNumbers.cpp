@@ -7,7 +7,9 @@ SPDX-License-Identifier: BSD-3-Clause
 #include "test.hpp"
 #include "units/units.hpp"
 
+#include <clocale>
 #include <cmath>
+#include <string>
 
 using namespace units::detail::testing;
 
@@ -192,6 +194,54 @@ TEST(leadingNumbers, edge_cases)
     EXPECT_EQ(res, 0.0);
 }
 
+TEST(leadingNumbers, exact_rounding)
+{
+    size_t index = 0;
+    auto res = testLeadingNumber("0.30000000000000004", index);
+    EXPECT_EQ(res, 0.1 + 0.2);
+    EXPECT_EQ(index, 19U);
+
+    res = testLeadingNumber("9007199254740993", index);
+    EXPECT_EQ(res, 9007199254740992.0);
+
+    res = testLeadingNumber("1.7976931348623157e308", index);
+    EXPECT_EQ(res, 1.7976931348623157e308);
+
+    res = testLeadingNumber("2.2250738585072014e-308", index);
+    EXPECT_EQ(res, 2.2250738585072014e-308);
+
+    res = testLeadingNumber("123456789012345678901234567890m", index);
+    EXPECT_EQ(res, 123456789012345678901234567890.0);
+    EXPECT_EQ(index, 30U);
+
+    res = testLeadingNumber("1e400", index);
+    EXPECT_TRUE((std::isinf)(res));
+
+    res = testLeadingNumber("0x1.8p1", index);
+    EXPECT_EQ(res, 3.0);
+    EXPECT_EQ(index, 7U);
+
+    res = testLeadingNumber("2em", index);
+    EXPECT_EQ(res, 2.0);
+    EXPECT_EQ(index, 1U);
+}
+
+TEST(leadingNumbers, locale_independent)
+{
+    const char* previous = std::setlocale(LC_NUMERIC, nullptr);
+    std::string saved = (previous != nullptr) ? previous : "C";
+    for (const char* loc : {"de_DE.UTF-8", "de_DE", "fr_FR.UTF-8", "German"}) {
+        if (std::setlocale(LC_NUMERIC, loc) != nullptr) {
+            break;
+        }
+    }
+    size_t index = 0;
+    auto res = testLeadingNumber("56.7*2.5m", index);
+    std::setlocale(LC_NUMERIC, saved.c_str());
+    EXPECT_EQ(res, 56.7 * 2.5);
+    EXPECT_EQ(index, 8U);
+}
+
 TEST(numericalwords, simple)
 {
     size_t index{0U};
@@ -0,0 +1,214 @@
+/*
+Copyright (c) 2019-2022,
+Lawrence Livermore National Security, LLC;
+See the top-level NOTICE for additional details. All rights reserved.
+SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#include "test.hpp"
+#include "units/units_array.hpp"
+
+#include <cmath>
+#include <vector>
+
+using namespace units;
+
+TEST(measurementArray, construction)
+{
+    measurement_array arr1({1.0, 2.5, -4.0}, ft);
+    EXPECT_EQ(arr1.size(), 3U);
+    EXPECT_EQ(arr1.units(), ft);
+    EXPECT_EQ(arr1[1], 2.5);
+    EXPECT_EQ(arr1.measurement_at(2), measurement(-4.0, ft));
+
+    arr1.push_back(measurement(12.0, in));
+    EXPECT_EQ(arr1.size(), 4U);
+    EXPECT_NEAR(arr1[3], 1.0, 1e-6);
+
+    precise_measurement_array arr2(5, 2.0, precise::kg);
+    double sum = 0.0;
+    for (auto val : arr2) {
+        sum += val;
+    }
+    EXPECT_EQ(sum, 10.0);
+
+    measurement_array arr3;
+    EXPECT_TRUE(arr3.empty());
+    EXPECT_EQ(arr3.units(), one);
+}
+
+TEST(measurementArray, conversionsMatchScalar)
+{
+    std::vector<double> vals;
+    for (int ii = 0; ii < 257; ++ii) {
+        vals.push_back(static_cast<double>(ii) * 0.37 - 11.3);
+    }
+    const precise_unit targets[] = {
+        precise::in,
+        precise::km,
+        precise::mm,
+        precise::m,
+        precise::s,
+        precise_unit(1.0 + 1e-15, precise::ft)};
+    precise_measurement_array arr(vals, precise::ft);
+    for (const auto& target : targets) {
+        auto converted = arr.convert_to(target);
+        ASSERT_EQ(converted.size(), vals.size());
+        EXPECT_EQ(converted.units(), target);
+        for (std::size_t ii = 0; ii < vals.size(); ++ii) {
+            auto scalar = precise_measurement(vals[ii], precise::ft);
+            auto expected = scalar.value_as(target);
+            if (std::isnan(expected)) {
+                EXPECT_TRUE(std::isnan(converted[ii]));
+            } else {
+                EXPECT_EQ(converted[ii], expected);
+            }
+        }
+    }
+    // non linear conversions use the scalar conversion for each value
+    precise_measurement_array temps({-40.0, 0.0, 32.0, 98.6}, precise::degF);
+    auto celsius = temps.value_as(precise::degC);
+    for (std::size_t ii = 0; ii < temps.size(); ++ii) {
+        EXPECT_EQ(
+            celsius[ii],
+            precise_measurement(temps[ii], precise::degF)
+                .value_as(precise::degC));
+    }
+    EXPECT_DOUBLE_EQ(celsius[0], -40.0);
+}
+
+TEST(measurementArray, arithmetic)
+{
+    measurement_array lengths({1.0, 2.0, 3.0}, m);
+    measurement_array times({2.0, 4.0, 0.5}, s);
+
+    auto speeds = lengths / times;
+    EXPECT_EQ(speeds.units(), m / s);
+    EXPECT_EQ(speeds[2], 6.0);
+    EXPECT_EQ((lengths * times).units(), m * s);
+
+    auto doubled = 2.0 * lengths;
+    EXPECT_EQ(doubled[1], 4.0);
+    EXPECT_EQ(doubled.units(), m);
+    auto inverted = 6.0 / lengths;
+    EXPECT_EQ(inverted.units(), m.inv());
+    EXPECT_EQ(inverted[2], 2.0);
+
+    auto scaled = lengths * measurement(3.0, N);
+    EXPECT_EQ(scaled.units(), m * N);
+    EXPECT_EQ(scaled[0], 3.0);
+    EXPECT_EQ((lengths / s).units(), m / s);
+
+    measurement_array feet({1.0, 2.0, 3.0}, ft);
+    auto sum = lengths + feet;
+    EXPECT_EQ(sum.units(), m);
+    auto diff = lengths - feet;
+    for (std::size_t ii = 0; ii < lengths.size(); ++ii) {
+        auto m1 = lengths.measurement_at(ii);
+        auto m2 = feet.measurement_at(ii);
+        EXPECT_EQ(sum[ii], (m1 + m2).value());
+        EXPECT_EQ(diff[ii], (m1 - m2).value());
+    }
+
+    auto shifted = lengths + measurement(50.0, cm);
+    EXPECT_NEAR(shifted[0], 1.5, 1e-6);
+    shifted -= measurement(0.5, m);
+    EXPECT_NEAR(shifted[0], 1.0, 1e-6);
+
+    measurement_array short_array({1.0}, m);
+    auto bad = lengths + short_array;
+    EXPECT_TRUE(bad.empty());
+    EXPECT_TRUE(is_error(bad.units()));
+}
+
+TEST(measurementColumn, dictionary)
+{
+    precise_measurement_column column;
+    EXPECT_TRUE(column.push_back(5.0, precise::electrical::kW));
+    EXPECT_TRUE(column.push_back(2500.0, precise::W));
+    EXPECT_TRUE(column.push_back(1.5, precise::MW));
+    EXPECT_TRUE(
+        column.push_back(precise_measurement(7.0, precise::electrical::kW)));
+    EXPECT_EQ(column.size(), 4U);
+    ASSERT_EQ(column.dictionary().size(), 3U);
+    EXPECT_EQ(column.unit_indices()[3], column.unit_indices()[0]);
+    EXPECT_EQ(column.units(2), precise::MW);
+    EXPECT_EQ(
+        column.measurement_at(1),
+        precise_measurement(2.5, precise::electrical::kW));
+
+    // invalid units are stored once in the dictionary
+    column.push_back(1.0, precise::invalid);
+    column.push_back(2.0, precise::invalid);
+    EXPECT_EQ(column.dictionary().size(), 4U);
+}
+
+TEST(measurementColumn, normalizeMatchesScalar)
+{
+    const precise_unit units_to_test[] = {
+        precise::electrical::kW,
+        precise::W,
+        precise::MW,
+        precise::hp,
+        precise::degF,
+        precise::K,
+        precise::invalid};
+    std::vector<precise_measurement> measurements;
+    for (int ii = 0; ii < 300; ++ii) {
+        measurements.emplace_back(
+            static_cast<double>(ii) * 1.7 - 30.0, units_to_test[ii % 7]);
+    }
+    precise_measurement_column column(measurements);
+    EXPECT_EQ(column.dictionary().size(), 7U);
+
+    const precise_unit targets[] = {precise::W, precise::degC, precise::kg};
+    for (const auto& target : targets) {
+        auto values = column.value_as(target);
+        ASSERT_EQ(values.size(), measurements.size());
+        for (std::size_t ii = 0; ii < measurements.size(); ++ii) {
+            auto expected = measurements[ii].value_as(target);
+            if (std::isnan(expected)) {
+                EXPECT_TRUE(std::isnan(values[ii]));
+            } else {
+                EXPECT_EQ(values[ii], expected);
+            }
+        }
+    }
+    auto watts = column.convert_to(precise::W);
+    EXPECT_EQ(watts.units(), precise::W);
+    EXPECT_EQ(watts[0], 1000.0 * measurements[0].value());
+
+    auto round_trip = column.to_measurements();
+    ASSERT_EQ(round_trip.size(), measurements.size());
+    for (std::size_t ii = 0; ii < measurements.size(); ++ii) {
+        EXPECT_EQ(round_trip[ii].value(), measurements[ii].value());
+        EXPECT_TRUE(round_trip[ii].units().base_units() ==
+                    measurements[ii].units().base_units());
+    }
+}
+
+TEST(measurementColumn, groupByDimension)
+{
+    precise_measurement_column column;
+    column.push_back(5.0, precise::electrical::kW);
+    column.push_back(3.0, precise::m);
+    column.push_back(2500.0, precise::W);
+    column.push_back(12.0, precise::in);
+    column.push_back(32.0, precise::degF);
+
+    auto groups = column.group_by_dimension();
+    ASSERT_EQ(groups.size(), 3U);
+    EXPECT_EQ(groups[0].values.units(), precise::W);
+    ASSERT_EQ(groups[0].rows.size(), 2U);
+    EXPECT_EQ(groups[0].rows[1], 2U);
+    EXPECT_EQ(groups[0].values[0], 5000.0);
+    EXPECT_EQ(groups[0].values[1], 2500.0);
+
+    EXPECT_EQ(groups[1].values.units(), precise::m);
+    ASSERT_EQ(groups[1].values.size(), 2U);
+    EXPECT_DOUBLE_EQ(groups[1].values[1], 0.3048);
+
+    EXPECT_EQ(groups[2].values.units(), precise::K);
+    EXPECT_EQ(groups[2].rows[0], 4U);
+    EXPECT_NEAR(groups[2].values[0], 273.15, 1e-9);
+}
@@ -7,8 +7,11 @@ SPDX-License-Identifier: BSD-3-Clause
 #include "test.hpp"
 #include "units/units.hpp"
 
+#include <cmath>
 #include <iostream>
+#include <string>
 #include <type_traits>
+#include <vector>
 
 using namespace units;
 TEST(MeasurementStrings, basic)
@@ -59,6 +62,62 @@ TEST(MeasurementStrings, currency)
     EXPECT_EQ(pm, 9.99 * precise::currency);
 }
 
+TEST(MeasurementStrings, buffer)
+{
+    const char* buffer = "45 m,23.7 m/s";
+    auto pm = measurement_from_chars(buffer, 4);
+    EXPECT_EQ(pm, 45.0 * precise::m);
+    pm = measurement_from_chars(buffer + 5, 8);
+    EXPECT_EQ(pm, 23.7 * precise::m / precise::s);
+    pm = measurement_from_chars(buffer, 0);
+    EXPECT_EQ(pm.value(), 0.0);
+
+    const std::string field("45 m23");
+    std::vector<char> chars(field.begin(), field.end());
+    int length{4};
+    EXPECT_EQ(measurement_from_chars(chars.data(), length), 45.0 * precise::m);
+}
+
+#ifdef UNITS_HAS_STRING_VIEW
+TEST(MeasurementStrings, string_view)
+{
+    std::string_view field("99.9 N * m;");
+    auto pm = measurement_from_string(field.substr(0, 10));
+    EXPECT_EQ(pm, 99.9 * precise::N * precise::m);
+}
+#endif
+
+TEST(MeasurementStrings, batch)
+{
+    std::vector<std::string> column;
+    for (int ii = 0; ii < 300; ++ii) {
+        column.push_back(std::to_string(ii % 7) + " m/s");
+        column.emplace_back("$9.99");
+        column.emplace_back("12 {apples}");
+    }
+    auto results = measurements_from_strings(column, 0U, 3U);
+    ASSERT_EQ(results.size(), column.size());
+    for (std::size_t ii = 0; ii < column.size(); ++ii) {
+        EXPECT_EQ(results[ii], measurement_from_string(column[ii]))
+            << column[ii];
+    }
+    EXPECT_EQ(results[0], 0.0 * precise::m / precise::s);
+    EXPECT_EQ(results[1], 9.99 * precise::currency);
+}
+
+#ifdef UNITS_HAS_STRING_VIEW
+TEST(MeasurementStrings, batch_string_view)
+{
+    std::string_view buffer("45 m,23.7 m/s,45 m");
+    std::vector<std::string_view> fields{
+        buffer.substr(0, 4), buffer.substr(5, 8), buffer.substr(14, 4)};
+    auto results = measurements_from_strings(fields);
+    EXPECT_EQ(results[0], 45.0 * precise::m);
+    EXPECT_EQ(results[1], 23.7 * precise::m / precise::s);
+    EXPECT_EQ(results[2], results[0]);
+}
+#endif
+
 TEST(MeasurementToString, simple)
 {
     auto pm = precise_measurement(45.0, precise::m);
@@ -97,6 +156,105 @@ TEST(MeasurementToString, numbers)
     EXPECT_DOUBLE_EQ(m1.value(), 0.2);
 }
 
+TEST(MeasurementToChars, basic)
+{
+    char buffer[64];
+    auto res = to_chars(
+        buffer, buffer + sizeof(buffer), precise::kg / precise::m.pow(3));
+    EXPECT_EQ(res.ec, std::errc());
+    EXPECT_EQ(std::string(buffer, res.ptr), "kg/m^3");
+
+    res = to_chars(buffer, buffer + sizeof(buffer), 2.7 * puMW);
+    EXPECT_EQ(res.ec, std::errc());
+    EXPECT_EQ(std::string(buffer, res.ptr), "2.7 puMW");
+
+    precise_measurement pm(0.1 + 0.2, precise_unit(0.712412, precise::kg));
+    res = to_chars(buffer, buffer + sizeof(buffer), pm);
+    EXPECT_EQ(res.ec, std::errc());
+    std::string str(buffer, res.ptr);
+    EXPECT_EQ(str.compare(0, 29, "0.30000000000000004 (0.712412"), 0);
+    auto round_trip = measurement_from_string(str);
+    EXPECT_EQ(round_trip.value(), pm.value());
+    EXPECT_EQ(round_trip.units(), pm.units());
+
+    res = to_chars(buffer, buffer + 5, pm);
+    EXPECT_EQ(res.ec, std::errc::value_too_large);
+    EXPECT_EQ(res.ptr, buffer + 5);
+    res = to_chars(buffer, buffer + 3, precise::kg / precise::m.pow(3));
+    EXPECT_EQ(res.ec, std::errc::value_too_large);
+}
+
+TEST(MeasurementToChars, cached)
+{
+    enableToStringCache();
+    auto start = getToStringCacheStatistics();
+    char buffer[64];
+    auto density = 10.0 * precise::kg / precise::m.pow(3);
+    for (int ii = 0; ii < 3; ++ii) {
+        auto res = to_chars(buffer, buffer + sizeof(buffer), density);
+        EXPECT_EQ(res.ec, std::errc());
+        EXPECT_EQ(std::string(buffer, res.ptr), "10 kg/m^3");
+    }
+    EXPECT_EQ(getToStringCacheStatistics().hits - start.hits, 2U);
+    auto res = to_chars(buffer, buffer + 6, density);
+    EXPECT_EQ(res.ec, std::errc::value_too_large);
+    disableToStringCache();
+}
+
+TEST(MeasurementToString, batchDelimited)
+{
+    std::vector<precise_measurement> column{
+        {45.0, precise::m},
+        {0.1, precise::m},
+        {2.5, precise::kg / precise::m.pow(3)},
+        {-7.0, precise::m},
+        {constants::infinity, precise::m}};
+    EXPECT_EQ(
+        measurements_to_string(column),
+        "45,m\n0.1,m\n2.5,kg/m^3\n-7,m\ninf,m\n");
+    EXPECT_EQ(
+        measurements_to_string(column, record_format::delimited, '/'),
+        "45/m\n0.1/m\n2.5/\"kg/m^3\"\n-7/m\ninf/m\n");
+
+    std::vector<double> values{1.5, 0.30000000000000004, 1e300};
+    std::string output("value,unit\n");
+    measurements_to_string(
+        values.data(), values.size(), precise::MW * precise::hr, output);
+    EXPECT_EQ(
+        output,
+        "value,unit\n1.5,MWh\n0.30000000000000004,MWh\n1e+300,MWh\n");
+
+    // each record converts back to the original measurement
+    auto records = measurements_to_string(column);
+    std::size_t start{0};
+    for (const auto& meas : column) {
+        auto end = records.find('\n', start);
+        auto record = records.substr(start, end - start);
+        record[record.find(',')] = ' ';
+        auto round_trip = measurement_from_string(record);
+        EXPECT_EQ(round_trip.value(), meas.value()) << record;
+        EXPECT_EQ(round_trip.units(), meas.units()) << record;
+        start = end + 1;
+    }
+}
+
+TEST(MeasurementToString, batchNdjson)
+{
+    std::vector<precise_measurement> column{
+        {45.0, precise::m},
+        {std::nan(""), precise::m},
+        {3.0, precise::in}};
+    EXPECT_EQ(
+        measurements_to_string(column, record_format::ndjson),
+        "{\"value\":45,\"unit\":\"m\"}\n"
+        "{\"value\":null,\"unit\":\"m\"}\n"
+        "{\"value\":3,\"unit\":\"in\"}\n");
+    std::string output;
+    measurements_to_string(
+        nullptr, 0, precise::m, output, record_format::ndjson);
+    EXPECT_TRUE(output.empty());
+}
+
 TEST(MeasurementToString, case_sensitive)
 {
     static const std::vector<std::pair<unit, std::string>> twoc_units{
@@ -0,0 +1,154 @@
+/*
+Copyright (c) 2019-2022,
+Lawrence Livermore National Security, LLC;
+See the top-level NOTICE for additional details. All rights reserved.
+SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#include "test.hpp"
+#include "units/units_serialization.hpp"
+
+#include <cmath>
+#include <string>
+
+using namespace units;
+
+TEST(serialization, sizes)
+{
+    EXPECT_EQ(binary_size<unit>(), 9U);
+    EXPECT_EQ(binary_size<precise_unit>(), 17U);
+    EXPECT_EQ(binary_size<measurement>(), 17U);
+    EXPECT_EQ(binary_size<precise_measurement>(), 25U);
+    EXPECT_EQ(binary_size<uncertain_measurement>(), 17U);
+    EXPECT_EQ(ascii_size<precise_unit>(), 23U);
+    EXPECT_EQ(ascii_size<precise_measurement>(), 34U);
+}
+
+TEST(serialization, unitsExact)
+{
+    const precise_unit units_to_test[] = {
+        precise::m,
+        precise::N * precise::m / precise::s,
+        precise::one / precise::kg.pow(2),
+        precise_unit(1.0 / 3.0, precise::ft.pow(3)),
+        precise::degF,
+        precise::special::ASD,
+        precise::log::dB,
+        precise::iflag * precise::pu * precise::A,
+        precise_unit(precise::lb, 0x3FA4U),
+        precise_unit(precise::count, ~0x3FA4U),
+        precise::invalid,
+        precise::error};
+    for (const auto& un : units_to_test) {
+        auto data = to_binary(un);
+        ASSERT_EQ(data.size(), binary_size<precise_unit>());
+        auto decoded = from_binary<precise_unit>(data);
+        EXPECT_EQ(decoded.base_units(), un.base_units());
+        EXPECT_EQ(decoded.commodity(), un.commodity());
+        if (std::isnan(un.multiplier())) {
+            EXPECT_TRUE(std::isnan(decoded.multiplier()));
+        } else {
+            EXPECT_EQ(decoded.multiplier(), un.multiplier());
+        }
+
+        auto text = to_ascii(un);
+        ASSERT_EQ(text.size(), ascii_size<precise_unit>());
+        EXPECT_EQ(text.find_first_not_of(
+                      "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz"
+                      "0123456789-_"),
+                  std::string::npos);
+        EXPECT_EQ(from_ascii<precise_unit>(text).base_units(), un.base_units());
+
+        auto lowp = unit_cast(un);
+        auto ldecoded = from_binary<unit>(to_binary(lowp));
+        EXPECT_EQ(ldecoded.base_units(), lowp.base_units());
+        if (!std::isnan(lowp.multiplier_f())) {
+            EXPECT_EQ(ldecoded.multiplier_f(), lowp.multiplier_f());
+        }
+    }
+}
+
+TEST(serialization, canonicalBytes)
+{
+    // the format is independent of the platform byte order and bitfield layout
+    auto data = to_binary(precise_unit(precise::m, 2.0));
+    const unsigned char expected[] = {
+        0x02, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40};
+    if (detail::bitwidth::base_size == 4) {
+        ASSERT_EQ(data.size(), sizeof(expected));
+        for (std::size_t ii = 0; ii < sizeof(expected); ++ii) {
+            EXPECT_EQ(static_cast<unsigned char>(data[ii]), expected[ii]);
+        }
+    }
+    auto negative = to_binary(precise::s.inv());
+    EXPECT_EQ(
+        static_cast<unsigned char>(negative[1]),
+        (detail::bitwidth::base_size == 4) ? 0xF0U : 0x00U);
+}
+
+TEST(serialization, measurements)
+{
+    measurement m1(45.7, ft / s);
+    auto m2 = from_binary<measurement>(to_binary(m1));
+    EXPECT_EQ(m2.value(), m1.value());
+    EXPECT_TRUE(m2.units().is_exactly_the_same(m1.units()));
+
+    precise_measurement pm1(1e-7, precise::mm * precise::currency);
+    auto pm2 = from_ascii<precise_measurement>(to_ascii(pm1));
+    EXPECT_EQ(pm2.value(), pm1.value());
+    EXPECT_TRUE(pm2.units().is_exactly_the_same(pm1.units()));
+
+    uncertain_measurement um1(9.81F, 0.02F, m / s.pow(2));
+    auto um2 = from_binary<uncertain_measurement>(to_binary(um1));
+    EXPECT_EQ(um2.value_f(), um1.value_f());
+    EXPECT_EQ(um2.uncertainty_f(), um1.uncertainty_f());
+    EXPECT_EQ(um2.units(), um1.units());
+
+    fixed_measurement fm1(-12.0, kg);
+    auto fm2 = from_ascii<fixed_measurement>(to_ascii(fm1));
+    EXPECT_EQ(fm2.value(), fm1.value());
+    EXPECT_EQ(fm2.units(), fm1.units());
+
+    fixed_precise_measurement fpm1(3.25, precise::W * precise::h);
+    auto fpm2 = from_binary<fixed_precise_measurement>(to_binary(fpm1));
+    EXPECT_EQ(fpm2.value(), fpm1.value());
+    EXPECT_EQ(fpm2.units(), fpm1.units());
+}
+
+TEST(serialization, buffers)
+{
+    char buffer[64];
+    EXPECT_EQ(to_binary(precise::m, buffer, 10), 0U);
+    EXPECT_EQ(to_ascii(precise::m, buffer, 22), 0U);
+
+    // records can be written and read back in sequence
+    auto len1 = to_binary(precise_measurement(2.0, precise::m), buffer, 64);
+    auto len2 = to_binary(precise::kg, buffer + len1, 64 - len1);
+    EXPECT_EQ(len1 + len2, 42U);
+    EXPECT_EQ(
+        from_binary<precise_measurement>(buffer, len1 + len2),
+        precise_measurement(2.0, precise::m));
+    EXPECT_EQ(from_binary<precise_unit>(buffer + len1, len2), precise::kg);
+}
+
+TEST(serialization, invalidInput)
+{
+    auto data = to_binary(precise::m);
+    EXPECT_TRUE(is_error(from_binary<precise_unit>(data.data(), 16)));
+    // the type tag must match
+    EXPECT_TRUE(is_error(from_binary<unit>(data)));
+    EXPECT_FALSE(is_valid(from_binary<precise_measurement>(data)));
+    data[0] = static_cast<char>(data[0] | 0x20);
+    EXPECT_TRUE(is_error(from_binary<precise_unit>(data)));
+
+    auto text = to_ascii(precise::m);
+    EXPECT_EQ(from_ascii<precise_unit>(text), precise::m);
+    EXPECT_TRUE(is_error(from_ascii<precise_unit>(text.substr(1))));
+    text[4] = '+';
+    EXPECT_TRUE(is_error(from_ascii<precise_unit>(text)));
+    // nonzero bits past the end of the encoding are not canonical
+    text = to_ascii(precise::m);
+    text.back() = 'B';
+    EXPECT_TRUE(is_error(from_ascii<precise_unit>(text)));
+}
@@ -0,0 +1,122 @@
+/*
+Copyright (c) 2019-2022,
+Lawrence Livermore National Security, LLC;
+See the top-level NOTICE for additional details. All rights reserved.
+SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#include "test.hpp"
+#include "units/units_static.hpp"
+
+#include <cmath>
+#include <type_traits>
+
+using namespace units;
+namespace su = units::static_units;
+
+TEST(staticUnit, packing)
+{
+    const precise_unit units_to_test[] = {
+        precise::one,
+        precise::m,
+        precise::N,
+        precise::W.inv(),
+        precise::pu * precise::V,
+        precise::degF,
+        precise::log::dB,
+        precise::currency / precise::mol.pow(2),
+        precise_unit(precise::custom::custom_unit(7))};
+    for (const auto& unit : units_to_test) {
+        auto base = unit.base_units();
+        EXPECT_TRUE(
+            detail::unpackUnitData(detail::packUnitData(base)) == base);
+    }
+    static_assert(
+        std::is_same<su::J, static_unit_multiply<su::N, su::m>>::value,
+        "static units are built from type aliases");
+    EXPECT_EQ(su::N::value(), precise::N);
+    EXPECT_EQ(su::J::value(), precise::J);
+    EXPECT_EQ(su::kW::value(), precise::electrical::kW);
+    EXPECT_EQ(su::ft::value(), precise::ft);
+    EXPECT_EQ(su::lb::value(), precise::lb);
+    EXPECT_EQ(su::Hz::value(), precise::Hz);
+}
+
+TEST(staticMeasurement, arithmetic)
+{
+    constexpr static_measurement<su::m> len(3.0);
+    constexpr static_measurement<su::s> tm(2.0);
+    constexpr auto speed = len / tm;
+    static_assert(speed.value() == 1.5, "static arithmetic is constexpr");
+    static_assert(
+        sizeof(static_measurement<su::N>) == sizeof(double),
+        "static measurements hold only the value");
+    EXPECT_EQ(speed.units(), precise::m / precise::s);
+
+    static_measurement<su::kg> mass(4.0);
+    static_measurement<su::N> force = mass * (speed / tm);
+    EXPECT_EQ(force.value(), 3.0);
+    auto work = force * len;
+    EXPECT_EQ(work.units(), precise::J);
+    EXPECT_EQ((work / tm).units(), precise::W);
+    EXPECT_EQ((1.0 / tm).units(), precise::Hz);
+
+    auto sum = len + static_measurement<su::m>(1.0);
+    sum *= 2.0;
+    sum -= len;
+    EXPECT_EQ(sum.value(), 5.0);
+    EXPECT_EQ((-sum).value(), -5.0);
+    EXPECT_EQ((2.0 * sum / 4.0).value(), 2.5);
+    EXPECT_TRUE(len < sum);
+    EXPECT_TRUE(len != sum);
+}
+
+TEST(staticMeasurement, conversions)
+{
+    constexpr static_measurement<su::ft> feet(10.0);
+    constexpr static_measurement<su::m> meters = feet;
+    static_assert(
+        meters.value() == 10.0 * 0.3048, "static conversions are constexpr");
+    EXPECT_DOUBLE_EQ(feet.value_as<su::in>(), 120.0);
+    EXPECT_DOUBLE_EQ(feet.convert_to<su::yd>().value(), 10.0 / 3.0);
+    EXPECT_DOUBLE_EQ(feet.value_as(precise::mm), 3048.0);
+
+    // mixed units are added in the units of the left operand
+    auto total = meters + static_measurement<su::cm>(50.0);
+    EXPECT_DOUBLE_EQ(total.value(), 3.548);
+
+    static_assert(
+        !std::is_convertible<
+            static_measurement<su::ft>,
+            static_measurement<su::kg>>::value,
+        "different dimensions do not convert");
+    static_assert(
+        std::is_convertible<
+            static_measurement<su::kW>,
+            static_measurement<su::W>>::value,
+        "same dimensions convert");
+}
+
+TEST(staticMeasurement, dynamicInterop)
+{
+    static_measurement<su::km> dist(2.5);
+    precise_measurement pm = dist;
+    EXPECT_EQ(pm.units(), precise::km);
+    EXPECT_EQ(pm.value(), 2.5);
+    measurement meas = dist;
+    EXPECT_EQ(meas.units(), km);
+
+    static_measurement<su::m> fromPrecise =
+        precise_measurement(3.0, precise::ft);
+    EXPECT_DOUBLE_EQ(fromPrecise.value(), 0.9144);
+    static_measurement<su::mm> fromMeasurement = measurement(2.0, in);
+    EXPECT_NEAR(fromMeasurement.value(), 50.8, 1e-5);
+
+    static_measurement<su::kg> bad = precise_measurement(1.0, precise::m);
+    EXPECT_TRUE(std::isnan(bad.value()));
+
+    // temperatures go through the dynamic conversion
+    static_measurement<su::K> freezing =
+        precise_measurement(32.0, precise::degF);
+    EXPECT_NEAR(freezing.value(), 273.15, 1e-12);
+}
@@ -9,6 +9,8 @@ SPDX-License-Identifier: BSD-3-Clause
 #include "units/units.hpp"
 
 #include <memory>
+#include <string>
+#include <vector>
 
 using namespace units;
 TEST(uncertainOps, construction)
@@ -438,6 +440,39 @@ TEST(uncertainStrings, from_string)
     EXPECT_NO_THROW(um6 = uncertain_measurement_from_string(""));
     EXPECT_EQ(um6.uncertainty(), 0.0);
     EXPECT_EQ(um6.value(), 0.0);
+
+    auto um7 = uncertain_measurement_from_string(
+        "10.0 &plusmn; 0.5 meter per second");
+    EXPECT_EQ(um7.value(), 10.0);
+    EXPECT_EQ(um7.uncertainty(), 0.5);
+    EXPECT_EQ(um7.units(), m / s);
+
+    auto um8 = uncertain_measurement_from_string("10.0<u>+</u>0.5 m");
+    EXPECT_EQ(um8.value(), 10.0);
+    EXPECT_EQ(um8.uncertainty(), 0.5);
+    EXPECT_EQ(um8.units(), m);
+}
+
+TEST(uncertainStrings, from_buffer)
+{
+    const char* buffer = "12+/-3 m|4.563(4) m";
+    auto um1 = uncertain_measurement_from_chars(buffer, 8);
+    EXPECT_EQ(um1.value(), 12.0);
+    EXPECT_EQ(um1.uncertainty(), 3.0);
+    EXPECT_EQ(um1.units(), m);
+
+    auto um2 = uncertain_measurement_from_chars(buffer + 9, 10);
+    EXPECT_FLOAT_EQ(um2.value(), 4.563F);
+    EXPECT_EQ(um2.uncertainty(), 0.004F);
+    EXPECT_EQ(um2.units(), m);
+
+    const std::string field("12+/-3 m99");
+    std::vector<char> chars(field.begin(), field.end());
+    int length{8};
+    auto um3 = uncertain_measurement_from_chars(chars.data(), length);
+    EXPECT_EQ(um3.value(), 12.0);
+    EXPECT_EQ(um3.uncertainty(), 3.0);
+    EXPECT_EQ(um3.units(), m);
 }
 
 TEST(uncertainStrings, from_string_concise)
@@ -0,0 +1,81 @@
+/*
+Copyright (c) 2019-2022,
+Lawrence Livermore National Security, LLC;
+See the top-level NOTICE for additional details. All rights reserved.
+SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#include "test.hpp"
+#include "units/units.hpp"
+#include "units/units_literals.hpp"
+
+#ifdef UNITS_UNIT_LITERAL
+using namespace units;
+
+TEST(unitLiterals, constexprEvaluation)
+{
+    constexpr precise_unit newton = UNITS_UNIT_LITERAL("kg*m/s^2");
+    static_assert(
+        newton.base_units() == precise::N.base_units(),
+        "the literal is evaluated at compile time");
+    EXPECT_EQ(newton, precise::N);
+    constexpr auto speed = UNITS_UNIT_LITERAL("km/h");
+    EXPECT_EQ(speed, precise::km / precise::hr);
+    EXPECT_EQ(
+        UNITS_UNIT_LITERAL("(kg.m2)/(s2.A)"),
+        precise::kg * precise::m.pow(2) / (precise::s.pow(2) * precise::A));
+    EXPECT_EQ(UNITS_UNIT_LITERAL("m.s-1"), precise::m / precise::s);
+    EXPECT_EQ(
+        UNITS_UNIT_LITERAL("kN*m"), precise::kilo * precise::N * precise::m);
+    EXPECT_EQ(UNITS_UNIT_LITERAL("daN"), precise_unit(10.0, precise::N));
+    EXPECT_EQ(UNITS_UNIT_LITERAL("[in_i]^2"), precise::in.pow(2));
+    EXPECT_EQ(UNITS_UNIT_LITERAL("1/s"), precise::Hz);
+}
+
+TEST(unitLiterals, matchesStringConversion)
+{
+    struct literal_pair {
+        precise_unit literal;
+        const char* str;
+    };
+    const literal_pair pairs[] = {
+        {UNITS_UNIT_LITERAL("kg*m/s^2"), "kg*m/s^2"},
+        {UNITS_UNIT_LITERAL("W/m^2"), "W/m^2"},
+        {UNITS_UNIT_LITERAL("mm"), "mm"},
+        {UNITS_UNIT_LITERAL("ft*lb"), "ft*lb"},
+        {UNITS_UNIT_LITERAL("mol/L"), "mol/L"},
+        {UNITS_UNIT_LITERAL("kW*h"), "kW*h"},
+        {UNITS_UNIT_LITERAL("J/(kg*K)"), "J/(kg*K)"},
+        {UNITS_UNIT_LITERAL("m^3/s"), "m^3/s"},
+        {UNITS_UNIT_LITERAL("uV"), "uV"},
+        {UNITS_UNIT_LITERAL("GHz"), "GHz"},
+        {UNITS_UNIT_LITERAL("mg/dL"), "mg/dL"},
+        {UNITS_UNIT_LITERAL("[lb_av]"), "[lb_av]"},
+        {UNITS_UNIT_LITERAL("N.m"), "N.m"},
+        {UNITS_UNIT_LITERAL("cm2"), "cm2"},
+        {UNITS_UNIT_LITERAL("s^-1"), "s^-1"},
+        {UNITS_UNIT_LITERAL("psi"), "psi"},
+        {UNITS_UNIT_LITERAL("degC"), "degC"},
+        {UNITS_UNIT_LITERAL("mph"), "mph"},
+    };
+    for (const auto& pair : pairs) {
+        EXPECT_EQ(pair.literal, unit_from_string(pair.str)) << pair.str;
+    }
+}
+#endif
+
+#ifdef UNITS_HAS_UNIT_LITERALS
+TEST(unitLiterals, userDefinedLiteral)
+{
+    using namespace units::literals;
+    constexpr auto force = "kg*m/s^2"_unit;
+    static_assert(
+        force.base_units() == units::precise::N.base_units(),
+        "the literal is evaluated at compile time");
+    EXPECT_EQ("W/m^2"_unit, units::unit_from_string("W/m^2"));
+    EXPECT_EQ("[lb_av]"_unit, units::precise::lb);
+    // the literal is consteval so this is evaluated at compile time as well
+    auto runtime_use = "mg/dL"_unit;
+    EXPECT_EQ(runtime_use, units::unit_from_string("mg/dL"));
+}
+#endif
@@ -0,0 +1,93 @@
+/*
+Copyright (c) 2019-2022,
+Lawrence Livermore National Security, LLC;
+See the top-level NOTICE for additional details. All rights reserved.
+SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#include "test.hpp"
+#include "units/units.hpp"
+
+#include <thread>
+#include <vector>
+
+using namespace units;
+
+TEST(unitRegistry, intern)
+{
+    auto id1 = internUnit(precise::m / precise::s);
+    auto id2 = internUnit(precise::kg);
+    EXPECT_NE(id1, invalid_unit_id);
+    EXPECT_NE(id1, id2);
+    EXPECT_EQ(internUnit(precise::m / precise::s), id1);
+    EXPECT_EQ(getUnitId(precise::kg), id2);
+    EXPECT_EQ(getInternedUnit(id1), precise::m / precise::s);
+    EXPECT_EQ(getInternedUnit(id2), precise::kg);
+
+    // units are matched exactly not through rounding of the multiplier
+    auto close = precise_unit(1.0 + 1e-14, precise::kg);
+    EXPECT_EQ(getUnitId(close), invalid_unit_id);
+    auto id3 = internUnit(close);
+    EXPECT_NE(id3, id2);
+    EXPECT_EQ(getInternedUnit(id3).multiplier(), close.multiplier());
+
+    auto id4 = internUnit(precise_unit(1.0, precise::lb, getCommodity("gold")));
+    EXPECT_EQ(getInternedUnit(id4).commodity(), getCommodity("gold"));
+    EXPECT_NE(id4, getUnitId(precise::lb));
+
+    EXPECT_GE(getInternedUnitCount(), 4U);
+    EXPECT_TRUE(is_error(getInternedUnit(invalid_unit_id)));
+    EXPECT_EQ(getUnitId(precise_unit(7.77e-33, precise::cd)), invalid_unit_id);
+}
+
+TEST(unitRegistry, concurrent)
+{
+    const int threadCount = 4;
+    std::vector<std::vector<unit_id>> ids(threadCount);
+    std::vector<std::thread> threads;
+    for (int ii = 0; ii < threadCount; ++ii) {
+        threads.emplace_back([ii, &ids]() {
+            for (int jj = 0; jj < 500; ++jj) {
+                auto un = precise_unit(
+                    static_cast<double>(jj) + 0.125, precise::mol);
+                auto id = internUnit(un);
+                ids[ii].push_back(id);
+                EXPECT_EQ(getInternedUnit(id), un);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    for (int ii = 1; ii < threadCount; ++ii) {
+        EXPECT_EQ(ids[ii], ids[0]);
+    }
+}
+
+TEST(internedMeasurement, basic)
+{
+    static_assert(
+        sizeof(interned_measurement) == 10,
+        "interned_measurement should not be padded");
+    interned_measurement im1(25.0, precise::ft);
+    EXPECT_EQ(im1.value(), 25.0);
+    EXPECT_EQ(im1.units(), precise::ft);
+    EXPECT_EQ(im1.id(), getUnitId(precise::ft));
+    EXPECT_NEAR(im1.value_as(precise::in), 300.0, 1e-12);
+
+    interned_measurement im2(precise_measurement(300.0, precise::in));
+    EXPECT_FALSE(im1.has_same_unit(im2));
+    EXPECT_TRUE(im1 == im2);
+
+    interned_measurement im3(25.0, im1.id());
+    EXPECT_TRUE(im3.has_same_unit(im1));
+    EXPECT_EQ(im3, im1);
+    EXPECT_NE(interned_measurement(26.0, im1.id()), im1);
+
+    precise_measurement pm = im2;
+    EXPECT_EQ(pm.value(), 300.0);
+    EXPECT_EQ(pm.units(), precise::in);
+
+    std::vector<interned_measurement> column(100);
+    EXPECT_EQ(column[5].id(), invalid_unit_id);
+}
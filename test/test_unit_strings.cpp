@@ -8,6 +8,10 @@ SPDX-License-Identifier: BSD-3-Clause
 
 #include "test.hpp"
 #include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <thread>
+#include <vector>
 
 #if (__cplusplus >= 201703L) || (defined(_MSVC_LANG) && _MSVC_LANG >= 201703)
 #ifndef UNITS_CONSTEXPR_IF_SUPPORTED
@@ -238,6 +242,23 @@ TEST(unitStrings, invtestUnits)
     EXPECT_EQ(res, "1/(Mcd*day)");
 }
 
+TEST(unitStrings, probeUnits)
+{
+    EXPECT_EQ(to_string(precise::W / precise::ft.pow(2)), "W/ft^2");
+    EXPECT_EQ(
+        to_string(precise::V * precise::s.pow(2) / precise::mol), "V*s^2/mol");
+    EXPECT_EQ(
+        to_string(precise::kg * precise::m / precise::s.pow(3) / precise::mol),
+        "W*m^-1*mol^-1");
+
+    // user defined units are probed regardless of their dimensions
+    precise_unit clucks(19.3, precise::m * precise::A);
+    addUserDefinedUnit("clucks", clucks);
+    EXPECT_EQ(to_string(clucks / precise::mol), "clucks/mol");
+    EXPECT_EQ(to_string(clucks * precise::cd), "cd*clucks");
+    clearUserDefinedUnits();
+}
+
 TEST(unitStrings, downconvert)
 {
     EXPECT_EQ(
@@ -449,6 +470,62 @@ TEST(stringToUnits, specificCombinations)
     EXPECT_EQ(precise::kg * precise::L, unit_from_string("kg l"));
 }
 
+TEST(stringToUnits, partitioning)
+{
+    EXPECT_EQ(unit_from_string("kWhpermonth"), unit_from_string("kWh/month"));
+    EXPECT_EQ(unit_from_string("ampsecond"), precise::A * precise::s);
+    EXPECT_EQ(unit_from_string("Wattminute"), precise::W * precise::min);
+
+    // user defined units are found in merged strings
+    addUserDefinedUnit("clucks", precise::one / precise::s);
+    EXPECT_EQ(unit_from_string("clucksmeter"), precise::m / precise::s);
+    clearUserDefinedUnits();
+    EXPECT_FALSE(is_valid(unit_from_string("clucksmeter")));
+}
+
+TEST(stringToUnits, instrumentation)
+{
+    resetParseStatistics();
+    // nothing is collected while instrumentation is off
+    EXPECT_EQ(unit_from_string("m"), precise::m);
+    EXPECT_EQ(getParseStatistics().conversions, 0U);
+
+    enableParseInstrumentation(1);
+    EXPECT_EQ(unit_from_string("m"), precise::m);
+    EXPECT_EQ(unit_from_string("kg/m"), precise::kg / precise::m);
+    EXPECT_EQ(unit_from_string("kWhpermonth"), unit_from_string("kWh/month"));
+    EXPECT_FALSE(is_valid(unit_from_string("zzqqxx")));
+    disableParseInstrumentation();
+    EXPECT_EQ(unit_from_string("m"), precise::m);
+
+    auto stats = getParseStatistics();
+    EXPECT_EQ(stats.conversions, 5U);
+    EXPECT_EQ(stats.failures, 1U);
+    auto phase = [&stats](parse_phase ph) {
+        return stats.resolutions[static_cast<std::size_t>(ph)];
+    };
+    EXPECT_EQ(phase(parse_phase::direct_lookup), 1U);
+    EXPECT_EQ(phase(parse_phase::operator_split), 2U);
+    std::uint64_t resolved{0};
+    for (auto res : stats.resolutions) {
+        resolved += res;
+    }
+    EXPECT_EQ(resolved, stats.conversions - stats.failures);
+    EXPECT_GT(stats.string_copies, 0U);
+    EXPECT_GE(stats.max_recursion_depth, 2U);
+    EXPECT_GE(stats.total_recursion_depth, stats.conversions);
+    EXPECT_EQ(stats.latency_samples, 5U);
+    std::uint64_t sampled{0};
+    for (auto bucket : stats.latency_histogram) {
+        sampled += bucket;
+    }
+    EXPECT_EQ(sampled, stats.latency_samples);
+
+    resetParseStatistics();
+    EXPECT_EQ(getParseStatistics().conversions, 0U);
+    EXPECT_EQ(getParseStatistics().latency_samples, 0U);
+}
+
 TEST(stringToUnits, gas_constant)
 {
     auto rval = unit_from_string("J mol^-1 K^-1");
@@ -961,6 +1038,44 @@ TEST(userDefinedUnits, clearDefs)
     EXPECT_NE(to_string(clucks), "clucks");
 }
 
+TEST(userDefinedUnits, concurrentUpdates)
+{
+    precise_unit clucks(19.3, precise::m * precise::A);
+    addUserDefinedUnit("clucks", clucks);
+    std::atomic<bool> done{false};
+    std::atomic<int> failures{0};
+    std::vector<std::thread> readers;
+    for (int tt = 0; tt < 3; ++tt) {
+        readers.emplace_back([&done, &failures, &clucks]() {
+            while (!done.load()) {
+                if (unit_from_string("clucks/A") !=
+                    precise_unit(19.3, precise::m)) {
+                    ++failures;
+                }
+                if (unit_from_string("kg*m/s^2") != precise::N) {
+                    ++failures;
+                }
+                if (to_string(clucks) != "clucks") {
+                    ++failures;
+                }
+            }
+        });
+    }
+    for (int ii = 0; ii < 200; ++ii) {
+        std::string name = "widget" + std::to_string(ii);
+        addUserDefinedUnit(name, precise_unit(ii + 2.0, precise::cd));
+        addUserDefinedInputUnit("in_" + name, precise::mol);
+    }
+    done.store(true);
+    for (auto& thread : readers) {
+        thread.join();
+    }
+    EXPECT_EQ(failures.load(), 0);
+    EXPECT_EQ(unit_from_string("widget199"), precise_unit(201.0, precise::cd));
+    clearUserDefinedUnits();
+    EXPECT_FALSE(is_valid(unit_from_string("widget5")));
+}
+
 TEST(userDefinedUnits, fileOp1)
 {
     auto outputstr = definedUnitsFromFile(TEST_FILE_FOLDER
@@ -1035,6 +1150,247 @@ TEST(userDefinedUnits, badDefinitions)
     EXPECT_EQ(cnt, 5);
 }
 
+TEST(unitStrings, buffer)
+{
+    const char* buffer = "kg/m^3,MW*h";
+    EXPECT_EQ(unit_from_chars(buffer, 6), precise::kg / precise::m.pow(3));
+    EXPECT_EQ(unit_from_chars(buffer + 7, 4), precise::MW * precise::hr);
+    EXPECT_EQ(unit_from_chars(buffer, 0), precise::one);
+
+    enableParseCache();
+    EXPECT_EQ(unit_from_chars(buffer + 7, 4), precise::MW * precise::hr);
+    EXPECT_EQ(unit_from_string(std::string("MW*h")), precise::MW * precise::hr);
+    EXPECT_EQ(unit_from_chars(buffer + 7, 2), precise::MW);
+    disableParseCache();
+}
+
+TEST(unitStrings, unterminatedBuffer)
+{
+    // the characters are followed by more text and no null terminator
+    const std::string field("kg/m^3kg");
+    std::vector<char> chars(field.begin(), field.end());
+    std::size_t length{6};
+    EXPECT_EQ(
+        unit_from_chars(chars.data(), length), precise::kg / precise::m.pow(3));
+    EXPECT_EQ(
+        unit_from_chars(chars.data(), chars.size()), unit_from_string(field));
+    // lengths of any integer type are lengths
+    const char exact[8] = {'k', 'g', '/', 'm', '^', '3', 'k', 'g'};
+    int intLength{6};
+    EXPECT_EQ(
+        unit_from_chars(exact, intLength, 0U),
+        precise::kg / precise::m.pow(3));
+    unsigned int unsignedLength{2};
+    EXPECT_EQ(unit_from_chars(exact, unsignedLength), precise::kg);
+    // the second argument of unit_from_string is always the match flags
+    std::uint32_t flags{case_insensitive};
+    EXPECT_EQ(unit_from_string("CM2", true), unit_from_string("cm2"));
+    EXPECT_EQ(unit_from_string("m", flags), precise::m);
+    EXPECT_EQ(unit_from_string("m", strict_si | single_slash), precise::m);
+}
+
+#ifdef UNITS_HAS_STRING_VIEW
+TEST(unitStrings, string_view)
+{
+    std::string_view ustring("kg*m/s^2 and more");
+    EXPECT_EQ(unit_from_string(ustring.substr(0, 8)), precise::N);
+    EXPECT_EQ(unit_from_string("m", case_insensitive), precise::m);
+}
+#endif
+
+TEST(unitStrings, batch)
+{
+    std::vector<std::string> column;
+    for (int ii = 0; ii < 500; ++ii) {
+        column.emplace_back((ii % 3 == 0) ? "kg/m^3" : "MW*h");
+        column.emplace_back("degF");
+        column.emplace_back(std::to_string(ii) + " m");
+    }
+    auto results = units_from_strings(column);
+    ASSERT_EQ(results.size(), column.size());
+    for (std::size_t ii = 0; ii < column.size(); ++ii) {
+        EXPECT_EQ(results[ii], unit_from_string(column[ii])) << column[ii];
+    }
+
+    auto threaded = units_from_strings(column, 0U, 4U);
+    for (std::size_t ii = 0; ii < column.size(); ++ii) {
+        EXPECT_EQ(threaded[ii], results[ii]) << column[ii];
+    }
+
+    const char* buffers[] = {"m", "m{cloth}", "blarg", "m"};
+    std::size_t lengths[] = {1, 8, 5, 1};
+    precise_unit out[4];
+    units_from_strings(buffers, lengths, 4, out, 0U, 0U);
+    EXPECT_EQ(out[0], precise::m);
+    EXPECT_EQ(out[1], unit_from_string("m{cloth}"));
+    EXPECT_FALSE(is_valid(out[2]));
+    EXPECT_EQ(out[3], precise::m);
+
+    EXPECT_TRUE(units_from_strings(std::vector<std::string>{}).empty());
+}
+
+#ifdef ENABLE_UNIT_TESTING
+TEST(unitStrings, batchFailure)
+{
+    std::vector<std::string> column;
+    for (int ii = 0; ii < 1000; ++ii) {
+        column.push_back(std::to_string(ii) + " m");
+    }
+    // the exception is rethrown on the calling thread after the join
+    EXPECT_TRUE(detail::testing::testBatchFailure(
+        column.data(), column.size(), 0, 1U));
+    EXPECT_TRUE(detail::testing::testBatchFailure(
+        column.data(), column.size(), 999, 4U));
+    EXPECT_TRUE(detail::testing::testBatchFailure(
+        column.data(), column.size(), 500, 0U));
+}
+#endif
+
+TEST(parseCache, hitsAndMisses)
+{
+    enableParseCache(64);
+    auto start = getParseCacheStatistics();
+    EXPECT_EQ(start.capacity, 128U);
+
+    auto u1 = unit_from_string("kg/m^3");
+    auto u2 = unit_from_string("kg/m^3");
+    EXPECT_EQ(u1, precise::kg / precise::m.pow(3));
+    EXPECT_EQ(u1, u2);
+    auto u3 = unit_from_string("kg/m^3", case_insensitive);
+    EXPECT_EQ(u3, u1);
+
+    auto m1 = measurement_from_string("45 MW*h");
+    auto m2 = measurement_from_string("45 MW*h");
+    EXPECT_EQ(m1, m2);
+    EXPECT_EQ(m1.units(), precise::MW * precise::hr);
+
+    auto stats = getParseCacheStatistics();
+    EXPECT_EQ(stats.hits - start.hits, 2U);
+    EXPECT_EQ(stats.misses - start.misses, 3U);
+    EXPECT_GE(stats.entries, 3U);
+
+    clearParseCache();
+    EXPECT_EQ(getParseCacheStatistics().entries, 0U);
+    disableParseCache();
+    EXPECT_EQ(getParseCacheStatistics().capacity, 0U);
+    EXPECT_EQ(unit_from_string("kg/m^3"), u1);
+    EXPECT_EQ(getParseCacheStatistics().entries, 0U);
+}
+
+TEST(parseCache, bounded)
+{
+    enableParseCache(16);
+    for (int ii = 1; ii < 200; ++ii) {
+        auto meas = measurement_from_string(std::to_string(ii) + " m");
+        EXPECT_EQ(meas.value(), static_cast<double>(ii));
+    }
+    auto stats = getParseCacheStatistics();
+    EXPECT_LE(stats.entries, stats.capacity);
+    disableParseCache();
+}
+
+TEST(parseCache, userDefinedInvalidation)
+{
+    enableParseCache();
+    EXPECT_FALSE(is_valid(unit_from_string("clucks/A")));
+    precise_unit clucks(19.3, precise::m * precise::A);
+    addUserDefinedUnit("clucks", clucks);
+    EXPECT_EQ(unit_from_string("clucks/A"), precise_unit(19.3, precise::m));
+    EXPECT_EQ(
+        measurement_from_string("2 clucks").units(),
+        unit_from_string("clucks"));
+
+    clearUserDefinedUnits();
+    EXPECT_FALSE(is_valid(unit_from_string("clucks/A")));
+    disableParseCache();
+}
+
+TEST(parseCache, domainInvalidation)
+{
+    enableParseCache();
+    auto def = unit_from_string("rad");
+    setUnitsDomain(domains::nuclear);
+    auto nuc = unit_from_string("rad");
+    setUnitsDomain(domains::defaultDomain);
+    EXPECT_EQ(unit_from_string("rad"), def);
+    EXPECT_EQ(nuc, precise::cgs::RAD);
+    EXPECT_NE(def, nuc);
+    disableParseCache();
+}
+
+TEST(parseCache, threads)
+{
+    enableParseCache(256);
+    std::vector<std::thread> threads;
+    std::atomic<int> failures{0};
+    for (int tt = 0; tt < 4; ++tt) {
+        threads.emplace_back([&failures]() {
+            for (int ii = 0; ii < 500; ++ii) {
+                if (unit_from_string("kg*m/s^2") != precise::N) {
+                    ++failures;
+                }
+                if (unit_from_string("MW*h") != precise::MW * precise::hr) {
+                    ++failures;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(failures.load(), 0);
+    disableParseCache();
+}
+
+TEST(toStringCache, hitsAndInvalidation)
+{
+    auto derived = precise::kg * precise::m.pow(2) / precise::s.pow(3) /
+        precise::A.pow(2) / precise::mol;
+    auto plain = to_string(derived);
+
+    enableToStringCache(64);
+    auto start = getToStringCacheStatistics();
+    EXPECT_EQ(to_string(derived), plain);
+    EXPECT_EQ(to_string(derived), plain);
+    EXPECT_EQ(to_string(precise::kg / precise::m.pow(3)), "kg/m^3");
+    auto stats = getToStringCacheStatistics();
+    EXPECT_EQ(stats.hits - start.hits, 1U);
+    EXPECT_EQ(stats.misses - start.misses, 2U);
+    EXPECT_EQ(stats.entries, 2U);
+
+    // units differing only in the last bits of the multiplier are distinct
+    auto close = precise_unit(
+        derived.base_units(), std::nextafter(derived.multiplier(), 2.0));
+    to_string(close);
+    EXPECT_EQ(getToStringCacheStatistics().entries, 3U);
+
+    precise_unit clucks(19.3, precise::m * precise::A);
+    EXPECT_NE(to_string(clucks), "clucks");
+    addUserDefinedUnit("clucks", clucks);
+    EXPECT_EQ(to_string(clucks), "clucks");
+    clearUserDefinedUnits();
+    EXPECT_NE(to_string(clucks), "clucks");
+
+    clearToStringCache();
+    EXPECT_EQ(getToStringCacheStatistics().entries, 0U);
+    disableToStringCache();
+    EXPECT_EQ(getToStringCacheStatistics().capacity, 0U);
+    EXPECT_EQ(to_string(derived), plain);
+    EXPECT_EQ(getToStringCacheStatistics().entries, 0U);
+}
+
+TEST(unitStrings, domainUnits)
+{
+    EXPECT_EQ(unit_from_string("C", cooking_units), precise::us::cup);
+    EXPECT_EQ(unit_from_string("t", cooking_units), precise::us::tsp);
+    EXPECT_EQ(unit_from_string("T", us_customary_units), precise::us::tbsp);
+    EXPECT_EQ(unit_from_string("'", surveying_units), precise::us::foot);
+    EXPECT_EQ(unit_from_string("rd", nuclear_units), precise::cgs::RAD);
+    EXPECT_EQ(unit_from_string("a", strict_ucum), precise::time::aj);
+    EXPECT_EQ(unit_from_string("a", astronomy_units), precise::area::are);
+    EXPECT_EQ(unit_from_string("C"), precise::C);
+}
+
 TEST(defaultUnits, unitTypes)
 {
     EXPECT_EQ(default_unit("impedance quantity"), precise::ohm);
@@ -1246,6 +1602,57 @@ TEST(stringCleanup, test_9strings)
     EXPECT_EQ(res, "10.7*999999999999999999999999lb");
 }
 
+TEST(stringCleanup, inputNormalization)
+{
+    using detail::testing::testCleanUnitString;
+    EXPECT_EQ(testCleanUnitString("sq.m--US", 0), "squarem-US");
+    EXPECT_EQ(testCleanUnitString("sq.ft/sq.in", 0), "squareft/squarein");
+    EXPECT_EQ(testCleanUnitString("cu.m/degree", 0), "cubicm/deg");
+    EXPECT_EQ(testCleanUnitString("ampere-US", 0), "ampUS");
+    EXPECT_EQ(testCleanUnitString("metre^+2", 0), "meter^2");
+    EXPECT_EQ(testCleanUnitString("10-3m", 0), "1e-3m");
+    EXPECT_EQ(testCleanUnitString("B.Th.U./lb", 0), "BTU/lb");
+    EXPECT_EQ(testCleanUnitString("perunit(US)", 0), "puUS");
+    EXPECT_EQ(testCleanUnitString("kg--m", 0), "kg*m");
+    EXPECT_EQ(testCleanUnitString(u8"\u221AHz", 0), "rootHertz");
+    EXPECT_EQ(
+        testCleanUnitString(u8"kg\u00b7m\u00b2/s\u00b2", 0),
+        "kg*m^(2)/s^(2)");
+    EXPECT_EQ(testCleanUnitString(u8"m\u2212\u00b9", 0), "m^(-1)");
+    EXPECT_EQ(testCleanUnitString(u8"m\u207b\u00b9", 0), "m^(-1)");
+    EXPECT_EQ(testCleanUnitString(u8"1/\u00bds", 0), "1/(0.5)*s");
+    EXPECT_EQ(testCleanUnitString("m\xb2", 0), "m^(2)");
+    EXPECT_EQ(testCleanUnitString("m<sup>2</sup>", 0), "m^2");
+    EXPECT_EQ(testCleanUnitString("(1)^2m", 0), "m");
+}
+
+TEST(stringCleanup, longInputNormalization)
+{
+    // strings of 16 or more characters go through the block classification
+    using detail::testing::testCleanUnitString;
+    EXPECT_EQ(
+        testCleanUnitString("squaremillimeter<sup>2</sup>", 0),
+        "squaremillimeter^2");
+    EXPECT_EQ(
+        testCleanUnitString(u8"kilogram*meter\u00b2/second\u00b2", 0),
+        "kilogram*meter^(2)/second^(2)");
+    EXPECT_EQ(
+        testCleanUnitString("kilogrammeter/second^1", 0),
+        "kilogrammeter/second");
+    EXPECT_EQ(
+        testCleanUnitString("newtonmeter(1)^2*second", 0),
+        "newtonmeter*second");
+    EXPECT_EQ(
+        testCleanUnitString("kilogram  meter per second", 0),
+        "kilogrammeter/second");
+    EXPECT_EQ(
+        testCleanUnitString("meter/second\tsquared", 0),
+        "meter/second*squared");
+    EXPECT_EQ(
+        testCleanUnitString("kg/(m^1*squaresecond)", 0),
+        "kg/(m*squaresecond)");
+}
+
 TEST(stringGeneration, addPowerString)
 {
     std::string t1{"bbb"};
@@ -1509,4 +1916,17 @@ TEST(extra, x12)
     auto unit = x12_unit("NOT A VALID STRING");
     EXPECT_TRUE(is_error(unit));
 }
+
+TEST(extra, buffers)
+{
+    const char* codes = "YDZZZ";
+    EXPECT_EQ(x12_unit(codes, 2), precise::yd);
+    EXPECT_TRUE(is_error(x12_unit(codes, 1)));
+    EXPECT_TRUE(is_error(x12_unit(codes + 2, 3)));
+    EXPECT_EQ(x12_unit(std::string("YD")), precise::yd);
+    EXPECT_TRUE(is_error(dod_unit(codes + 3, 2)));
+    EXPECT_EQ(r20_unit(codes + 3, 2), precise::one / precise::count);
+    EXPECT_TRUE(is_error(r20_unit(codes + 2, 3)));
+    EXPECT_TRUE(is_error(r20_unit(codes, 0)));
+}
 #endif
@@ -0,0 +1,965 @@
+/*
+Copyright (c) 2019-2022,
+Lawrence Livermore National Security, LLC;
+See the top-level NOTICE for additional details. All rights reserved.
+SPDX-License-Identifier: BSD-3-Clause
+*/
+#include "units.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+// the vector kernels are limited to x86_64 where the scalar conversions also
+// use SSE2 arithmetic, so each operation rounds identically
+#if defined(__x86_64__) || defined(_M_X64)
+#include <emmintrin.h>
+#define UNITS_BULK_SSE2
+#if (defined(__GNUC__) || defined(__clang__)) && !defined(__INTEL_COMPILER)
+#include <immintrin.h>
+#define UNITS_BULK_X86_DISPATCH
+#endif
+#endif
+
+// the fast equation unit kernels are written with the vector extensions
+#if defined(__GNUC__) || defined(__clang__)
+#define UNITS_BULK_VECTOR_EXTENSIONS
+#endif
+
+/** @file
+bulk conversion of arrays of values between two units
+*/
+
+namespace UNITS_NAMESPACE {
+
+namespace {
+    /// a single arithmetic operation applied to every value
+    enum class bulk_op : std::uint8_t {
+        mul = 0,  //!< val*c
+        div = 1,  //!< val/c
+        add = 2,  //!< val+c
+        sub = 3,  //!< val-c
+        recip = 4,  //!< c/val
+    };
+
+    struct bulk_step {
+        bulk_op op;
+        double c;
+    };
+
+    /** the sequence of operations performed by convert for a pair of units
+    @details the steps repeat the operations of convert in the same order so
+    the results round identically*/
+    class bulk_program {
+      public:
+        bulk_program(const precise_unit& start, const precise_unit& result);
+
+        bool is_identity() const { return identity_; }
+        bool is_general() const { return general_; }
+        /// the steps apply to the values of equation units
+        bool is_equation() const { return equation_; }
+        const detail::unit_data& start_base() const { return startBase_; }
+        const detail::unit_data& result_base() const { return resultBase_; }
+        const bulk_step* steps() const { return steps_.data(); }
+        int size() const { return size_; }
+
+      private:
+        void push(bulk_op op, double c) { steps_[size_++] = {op, c}; }
+        void setTemperature(
+            const precise_unit& start,
+            const precise_unit& result);
+        std::array<bulk_step, 6> steps_{};
+        int size_{0};
+        bool identity_{false};
+        bool general_{false};
+        bool equation_{false};
+        detail::unit_data startBase_{0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+        detail::unit_data resultBase_{0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+    };
+
+    bulk_program::bulk_program(
+        const precise_unit& start,
+        const precise_unit& result)
+    {
+        // the checks follow the order of convert(val, start, result)
+        if (start == result || is_default(start) || is_default(result)) {
+            identity_ = true;
+            return;
+        }
+        const double smult = start.multiplier();
+        const double rmult = result.multiplier();
+        if ((start.has_e_flag() || result.has_e_flag()) &&
+            start.has_same_base(result.base_units())) {
+            if (is_temperature(start) || is_temperature(result)) {
+                setTemperature(start, result);
+                return;
+            }
+            if (start.has_same_base(precise::pressure::psi.base_units())) {
+                push(bulk_op::mul, smult);
+                if (start.has_e_flag() != result.has_e_flag()) {
+                    push(
+                        start.has_e_flag() ? bulk_op::add : bulk_op::sub,
+                        precise::pressure::atm.multiplier());
+                }
+                push(bulk_op::div, rmult);
+                return;
+            }
+        }
+        auto base_start = start.base_units();
+        auto base_result = result.base_units();
+        if (start.is_equation() || result.is_equation()) {
+            if (!base_start.equivalent_non_counting(base_result)) {
+                general_ = true;
+                return;
+            }
+            equation_ = true;
+            startBase_ = base_start;
+            resultBase_ = base_result;
+            push(bulk_op::mul, smult);
+            push(bulk_op::div, rmult);
+            return;
+        }
+        if (base_start == base_result ||
+            (!start.is_per_unit() && !result.is_per_unit() &&
+             base_start.has_same_base(base_result))) {
+            push(bulk_op::mul, smult);
+            push(bulk_op::div, rmult);
+            return;
+        }
+        if (start.is_per_unit() || result.is_per_unit() ||
+            base_start.equivalent_non_counting(base_result)) {
+            general_ = true;
+            return;
+        }
+        if (base_start.has_same_base(base_result.inv())) {
+            push(bulk_op::mul, smult);
+            push(bulk_op::mul, rmult);
+            push(bulk_op::recip, 1.0);
+            return;
+        }
+        general_ = true;
+    }
+
+    // the steps of detail::convertTemperature
+    void bulk_program::setTemperature(
+        const precise_unit& start,
+        const precise_unit& result)
+    {
+        if (is_temperature(start)) {
+            if (degF == unit_cast(start)) {
+                push(bulk_op::sub, 32.0);
+                push(bulk_op::mul, 5.0);
+                push(bulk_op::div, 9.0);
+            } else if (start.multiplier() != 1.0) {
+                push(bulk_op::mul, start.multiplier());
+            }
+            push(bulk_op::add, 273.15);
+        } else {
+            push(bulk_op::mul, start.multiplier());
+        }
+        if (is_temperature(result)) {
+            push(bulk_op::sub, 273.15);
+            if (degF == unit_cast(result)) {
+                push(bulk_op::mul, 9.0 / 5.0);
+                push(bulk_op::add, 32.0);
+            } else if (result.multiplier() != 1.0) {
+                push(bulk_op::div, result.multiplier());
+            }
+        } else {
+            push(bulk_op::div, result.multiplier());
+        }
+    }
+
+    inline double applyStep(double val, bulk_op op, double c)
+    {
+        switch (op) {
+            case bulk_op::mul:
+                return val * c;
+            case bulk_op::div:
+                return val / c;
+            case bulk_op::add:
+                return val + c;
+            case bulk_op::sub:
+                return val - c;
+            default:
+                return c / val;
+        }
+    }
+
+    using step_kernel =
+        void (*)(const double*, double*, std::size_t, bulk_step);
+
+    void scalarKernel(
+        const double* values,
+        double* output,
+        std::size_t elements,
+        bulk_step step)
+    {
+        for (std::size_t ii = 0; ii < elements; ++ii) {
+            output[ii] = applyStep(values[ii], step.op, step.c);
+        }
+    }
+
+#ifdef UNITS_BULK_SSE2
+    void sse2Kernel(
+        const double* values,
+        double* output,
+        std::size_t elements,
+        bulk_step step)
+    {
+        const __m128d cv = _mm_set1_pd(step.c);
+        std::size_t ii{0};
+        const std::size_t vend = elements - elements % 2;
+        switch (step.op) {
+            case bulk_op::mul:
+                for (; ii < vend; ii += 2) {
+                    _mm_storeu_pd(
+                        output + ii, _mm_mul_pd(_mm_loadu_pd(values + ii), cv));
+                }
+                break;
+            case bulk_op::div:
+                for (; ii < vend; ii += 2) {
+                    _mm_storeu_pd(
+                        output + ii, _mm_div_pd(_mm_loadu_pd(values + ii), cv));
+                }
+                break;
+            case bulk_op::add:
+                for (; ii < vend; ii += 2) {
+                    _mm_storeu_pd(
+                        output + ii, _mm_add_pd(_mm_loadu_pd(values + ii), cv));
+                }
+                break;
+            case bulk_op::sub:
+                for (; ii < vend; ii += 2) {
+                    _mm_storeu_pd(
+                        output + ii, _mm_sub_pd(_mm_loadu_pd(values + ii), cv));
+                }
+                break;
+            default:
+                for (; ii < vend; ii += 2) {
+                    _mm_storeu_pd(
+                        output + ii, _mm_div_pd(cv, _mm_loadu_pd(values + ii)));
+                }
+                break;
+        }
+        scalarKernel(values + ii, output + ii, elements - ii, step);
+    }
+#endif
+
+#ifdef UNITS_BULK_X86_DISPATCH
+    // fma is deliberately not enabled so no operations are contracted
+    __attribute__((target("avx2"))) void avx2Kernel(
+        const double* values,
+        double* output,
+        std::size_t elements,
+        bulk_step step)
+    {
+        const __m256d cv = _mm256_set1_pd(step.c);
+        std::size_t ii{0};
+        const std::size_t vend = elements - elements % 4;
+        switch (step.op) {
+            case bulk_op::mul:
+                for (; ii < vend; ii += 4) {
+                    _mm256_storeu_pd(
+                        output + ii,
+                        _mm256_mul_pd(_mm256_loadu_pd(values + ii), cv));
+                }
+                break;
+            case bulk_op::div:
+                for (; ii < vend; ii += 4) {
+                    _mm256_storeu_pd(
+                        output + ii,
+                        _mm256_div_pd(_mm256_loadu_pd(values + ii), cv));
+                }
+                break;
+            case bulk_op::add:
+                for (; ii < vend; ii += 4) {
+                    _mm256_storeu_pd(
+                        output + ii,
+                        _mm256_add_pd(_mm256_loadu_pd(values + ii), cv));
+                }
+                break;
+            case bulk_op::sub:
+                for (; ii < vend; ii += 4) {
+                    _mm256_storeu_pd(
+                        output + ii,
+                        _mm256_sub_pd(_mm256_loadu_pd(values + ii), cv));
+                }
+                break;
+            default:
+                for (; ii < vend; ii += 4) {
+                    _mm256_storeu_pd(
+                        output + ii,
+                        _mm256_div_pd(cv, _mm256_loadu_pd(values + ii)));
+                }
+                break;
+        }
+        sse2Kernel(values + ii, output + ii, elements - ii, step);
+    }
+
+    __attribute__((target("avx512f"))) void avx512Kernel(
+        const double* values,
+        double* output,
+        std::size_t elements,
+        bulk_step step)
+    {
+        const __m512d cv = _mm512_set1_pd(step.c);
+        std::size_t ii{0};
+        const std::size_t vend = elements - elements % 8;
+        switch (step.op) {
+            case bulk_op::mul:
+                for (; ii < vend; ii += 8) {
+                    _mm512_storeu_pd(
+                        output + ii,
+                        _mm512_mul_pd(_mm512_loadu_pd(values + ii), cv));
+                }
+                break;
+            case bulk_op::div:
+                for (; ii < vend; ii += 8) {
+                    _mm512_storeu_pd(
+                        output + ii,
+                        _mm512_div_pd(_mm512_loadu_pd(values + ii), cv));
+                }
+                break;
+            case bulk_op::add:
+                for (; ii < vend; ii += 8) {
+                    _mm512_storeu_pd(
+                        output + ii,
+                        _mm512_add_pd(_mm512_loadu_pd(values + ii), cv));
+                }
+                break;
+            case bulk_op::sub:
+                for (; ii < vend; ii += 8) {
+                    _mm512_storeu_pd(
+                        output + ii,
+                        _mm512_sub_pd(_mm512_loadu_pd(values + ii), cv));
+                }
+                break;
+            default:
+                for (; ii < vend; ii += 8) {
+                    _mm512_storeu_pd(
+                        output + ii,
+                        _mm512_div_pd(cv, _mm512_loadu_pd(values + ii)));
+                }
+                break;
+        }
+        sse2Kernel(values + ii, output + ii, elements - ii, step);
+    }
+#endif
+
+    step_kernel selectKernel()
+    {
+#ifdef UNITS_BULK_X86_DISPATCH
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f")) {
+            return &avx512Kernel;
+        }
+        if (__builtin_cpu_supports("avx2")) {
+            return &avx2Kernel;
+        }
+#endif
+#ifdef UNITS_BULK_SSE2
+        return &sse2Kernel;
+#else
+        return &scalarKernel;
+#endif
+    }
+
+    step_kernel activeKernel()
+    {
+        static const step_kernel kernel = selectKernel();
+        return kernel;
+    }
+
+#ifdef UNITS_BULK_VECTOR_EXTENSIONS
+    // the vector types are only used inside the kernels so their ABI is unused
+    typedef double v2df __attribute__((vector_size(16)));
+    typedef double v4df __attribute__((vector_size(32)));
+    typedef double v8df __attribute__((vector_size(64)));
+
+    constexpr double ln2{0.6931471805599453};
+    constexpr double log2e{1.4426950408889634};
+
+// bitwise select of vector lanes, the mask lanes are all ones or all zeros
+#define UNITS_VSELECT(VI, mask, a, b)                                          \
+    ((((VI)(a)) & (mask)) | (((VI)(b)) & ~(mask)))
+
+    /** compute 2^((val+offset)*scale) for an array of values
+    @details the argument is split into an integer and a fraction in
+    [-0.5,0.5], 2^fraction is a degree 13 Taylor polynomial of
+    exp(fraction*ln2) and the integer is added to the exponent bits.  Results
+    below 2^-1021 are flushed to zero*/
+    template<typename VD, int W>
+    __attribute__((always_inline)) inline void exp2Block(
+        const double* values,
+        double* output,
+        std::size_t elements,
+        double offset,
+        double scale)
+    {
+        using VI = decltype(VD{} > VD{});
+        const VD zero{};
+        const VD one = zero + 1.0;
+        const VD inf = zero + constants::infinity;
+        const VD magic = zero + 6755399441055744.0;  // 1.5*2^52
+        for (std::size_t ii = 0; ii < elements; ii += W) {
+            // a partial vector at the end goes through a padded buffer
+            const std::size_t lanes = (std::min)(elements - ii, std::size_t{W});
+            double buffer[W] = {};
+            const double* source = values + ii;
+            double* target = output + ii;
+            if (lanes < W) {
+                std::copy(source, source + lanes, buffer);
+                source = buffer;
+                target = buffer;
+            }
+            VD arg;
+            std::memcpy(&arg, source, sizeof(VD));
+            arg = (arg + offset) * scale;
+
+            const VI nan = (arg != arg);
+            const VI over = (arg >= 1024.0);
+            const VI under = (arg < -1021.0);
+            const VD clamped =
+                (VD)UNITS_VSELECT(VI, nan | over | under, zero, arg);
+            VD rounded = (clamped + magic) - magic;
+            const VD frac = (clamped - rounded) * ln2;
+            // 2^1024 is not representable so the top half step uses 2^1023*2
+            const VI top = (rounded > 1023.0);
+            rounded = (VD)UNITS_VSELECT(VI, top, rounded - 1.0, rounded);
+            const VD factor = (VD)UNITS_VSELECT(VI, top, one + one, one);
+
+            VD poly = zero + 1.0 / 6227020800.0;
+            poly = poly * frac + 1.0 / 479001600.0;
+            poly = poly * frac + 1.0 / 39916800.0;
+            poly = poly * frac + 1.0 / 3628800.0;
+            poly = poly * frac + 1.0 / 362880.0;
+            poly = poly * frac + 1.0 / 40320.0;
+            poly = poly * frac + 1.0 / 5040.0;
+            poly = poly * frac + 1.0 / 720.0;
+            poly = poly * frac + 1.0 / 120.0;
+            poly = poly * frac + 1.0 / 24.0;
+            poly = poly * frac + 1.0 / 6.0;
+            poly = poly * frac + 0.5;
+            poly = poly * frac + 1.0;
+            poly = poly * frac + 1.0;
+
+            const VI exponent = ((VI)(rounded + magic)) << 52;
+            VD result = (VD)((VI)poly + exponent) * factor;
+            result = (VD)UNITS_VSELECT(VI, under, zero, result);
+            result = (VD)UNITS_VSELECT(VI, over, inf, result);
+            result = (VD)UNITS_VSELECT(VI, nan, arg, result);
+            std::memcpy(target, &result, sizeof(VD));
+            if (lanes < W) {
+                std::copy(buffer, buffer + lanes, output + ii);
+            }
+        }
+    }
+
+    /** compute log2(val)*scale+offset for an array of values
+    @details the value is split into an exponent and a mantissa in
+    [sqrt(0.5),sqrt(2)), the log of the mantissa is the series
+    2*atanh(s) with s=(m-1)/(m+1) to the s^21 term
+    @param positive set to true if zero should produce NaN instead of -inf*/
+    template<typename VD, int W>
+    __attribute__((always_inline)) inline void log2Block(
+        const double* values,
+        double* output,
+        std::size_t elements,
+        double scale,
+        double offset,
+        bool positive)
+    {
+        using VI = decltype(VD{} > VD{});
+        const VD zero{};
+        const VD nanv = zero + constants::invalid_conversion;
+        const VD inf = zero + constants::infinity;
+        const VD one = zero + 1.0;
+        const VI mantissaMask = (VI)zero + 0x000FFFFFFFFFFFFFLL;
+        const VI oneBits = (VI)one;
+        const VI exponentBias = (VI)(zero + 4503599627370496.0);  // 2^52
+        for (std::size_t ii = 0; ii < elements; ii += W) {
+            // a partial vector at the end goes through a padded buffer
+            const std::size_t lanes = (std::min)(elements - ii, std::size_t{W});
+            double buffer[W] = {};
+            const double* source = values + ii;
+            double* target = output + ii;
+            if (lanes < W) {
+                std::copy(source, source + lanes, buffer);
+                source = buffer;
+                target = buffer;
+            }
+            VD val;
+            std::memcpy(&val, source, sizeof(VD));
+
+            const VI finite = (val > 0.0) & (val < inf);
+            VD special = (VD)UNITS_VSELECT(VI, val == inf, inf, nanv);
+            if (!positive) {
+                special = (VD)UNITS_VSELECT(VI, val == 0.0, -inf, special);
+            }
+            // subnormal values are scaled into the normal range
+            const VI tiny = (val < 2.2250738585072014e-308);
+            VD scaled = (VD)UNITS_VSELECT(VI, finite, val, one);
+            scaled = (VD)UNITS_VSELECT(
+                VI, tiny, scaled * 4503599627370496.0, scaled);
+            const VD adjust = (VD)UNITS_VSELECT(VI, tiny, zero - 52.0, zero);
+
+            const VI bits = (VI)scaled;
+            VD mantissa = (VD)((bits & mantissaMask) | oneBits);
+            const VD exponent =
+                (VD)(((bits >> 52) & 0x7FF) | exponentBias) -
+                4503599627370496.0 - 1023.0 + adjust;
+            const VI high = (mantissa > 1.4142135623730951);
+            mantissa = (VD)UNITS_VSELECT(VI, high, mantissa * 0.5, mantissa);
+            const VD upper = (VD)UNITS_VSELECT(VI, high, one, zero);
+
+            const VD ratio = (mantissa - 1.0) / (mantissa + 1.0);
+            const VD square = ratio * ratio;
+            VD poly = zero + 1.0 / 21.0;
+            poly = poly * square + 1.0 / 19.0;
+            poly = poly * square + 1.0 / 17.0;
+            poly = poly * square + 1.0 / 15.0;
+            poly = poly * square + 1.0 / 13.0;
+            poly = poly * square + 1.0 / 11.0;
+            poly = poly * square + 1.0 / 9.0;
+            poly = poly * square + 1.0 / 7.0;
+            poly = poly * square + 1.0 / 5.0;
+            poly = poly * square + 1.0 / 3.0;
+            poly = poly * square + 1.0;
+            // 2/ln(2) converts the natural log series to base 2
+            const VD log2m = poly * ratio * 2.8853900817779268;
+
+            VD result = ((exponent + upper) + log2m) * scale + offset;
+            special = special * scale + offset;
+            result = (VD)UNITS_VSELECT(VI, finite, result, special);
+            std::memcpy(target, &result, sizeof(VD));
+            if (lanes < W) {
+                std::copy(buffer, buffer + lanes, output + ii);
+            }
+        }
+    }
+
+#undef UNITS_VSELECT
+
+    using exp2_kernel =
+        void (*)(const double*, double*, std::size_t, double, double);
+    using log2_kernel =
+        void (*)(const double*, double*, std::size_t, double, double, bool);
+
+    void exp2Generic(
+        const double* values,
+        double* output,
+        std::size_t elements,
+        double offset,
+        double scale)
+    {
+        exp2Block<v2df, 2>(values, output, elements, offset, scale);
+    }
+
+    void log2Generic(
+        const double* values,
+        double* output,
+        std::size_t elements,
+        double scale,
+        double offset,
+        bool positive)
+    {
+        log2Block<v2df, 2>(values, output, elements, scale, offset, positive);
+    }
+
+#ifdef UNITS_BULK_X86_DISPATCH
+    __attribute__((target("avx2,fma"))) void exp2Avx2(
+        const double* values,
+        double* output,
+        std::size_t elements,
+        double offset,
+        double scale)
+    {
+        exp2Block<v4df, 4>(values, output, elements, offset, scale);
+    }
+
+    __attribute__((target("avx2,fma"))) void log2Avx2(
+        const double* values,
+        double* output,
+        std::size_t elements,
+        double scale,
+        double offset,
+        bool positive)
+    {
+        log2Block<v4df, 4>(values, output, elements, scale, offset, positive);
+    }
+#endif
+
+    struct fast_kernels {
+        exp2_kernel exp2;
+        log2_kernel log2;
+    };
+
+    fast_kernels selectFastKernels()
+    {
+#ifdef UNITS_BULK_X86_DISPATCH
+        // 512 bit versions of these kernels were measured to be slower
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+            return {&exp2Avx2, &log2Avx2};
+        }
+#endif
+        return {&exp2Generic, &log2Generic};
+    }
+
+    const fast_kernels& activeFastKernels()
+    {
+        static const fast_kernels kernels = selectFastKernels();
+        return kernels;
+    }
+
+    /** get the exponential form 2^((val+offset)*scale) of an equation unit
+    @return false if the unit has no exponential form*/
+    bool exponentialForm(
+        const detail::unit_data& UT,
+        double& offset,
+        double& scale)
+    {
+        const double log2ten = std::log2(10.0);
+        const bool power = precise::equations::is_power_unit(UT);
+        offset = 0.0;
+        switch (precise::custom::eq_type(UT)) {
+            case 0:
+            case 10:
+                scale = log2ten;
+                break;
+            case 1:
+                scale = log2e * (power ? 2.0 : 1.0);
+                break;
+            case 2:
+                scale = log2ten / (power ? 1.0 : 2.0);
+                break;
+            case 3:
+                scale = log2ten / (power ? 10.0 : 20.0);
+                break;
+            case 4:
+                scale = -log2ten;
+                break;
+            case 5:
+                scale = -std::log2(100.0);
+                break;
+            case 6:
+                scale = -std::log2(1000.0);
+                break;
+            case 7:
+                scale = -std::log2(50000.0);
+                break;
+            case 8:
+                scale = 1.0;
+                break;
+            case 9:
+                scale = log2e;
+                break;
+            case 11:
+                scale = log2ten / 10.0;
+                break;
+            case 12:
+                scale = log2ten / 2.0;
+                break;
+            case 13:
+                scale = log2ten / 20.0;
+                break;
+            case 14:
+                scale = std::log2(3.0);
+                break;
+            case 15:
+                scale = 2.0 * log2e;
+                break;
+            case 29:
+                offset = 10.7;
+                scale = 1.5 * log2ten;
+                break;
+            case 30:
+                offset = 3.2;
+                scale = 1.5 * log2ten;
+                break;
+            default:
+                return false;
+        }
+        return true;
+    }
+
+    /** get the logarithmic form log2(val)*scale+offset of an equation unit
+    @return false if the unit has no logarithmic form*/
+    bool logarithmicForm(
+        const detail::unit_data& UT,
+        double& scale,
+        double& offset)
+    {
+        const double log10two = std::log10(2.0);
+        const bool power = precise::equations::is_power_unit(UT);
+        offset = 0.0;
+        switch (precise::custom::eq_type(UT)) {
+            case 0:
+            case 10:
+                scale = log10two;
+                break;
+            case 1:
+                scale = ln2 * (power ? 0.5 : 1.0);
+                break;
+            case 2:
+                scale = log10two * (power ? 1.0 : 2.0);
+                break;
+            case 3:
+                scale = log10two * (power ? 10.0 : 20.0);
+                break;
+            case 4:
+                scale = -log10two;
+                break;
+            case 5:
+                scale = -log10two / 2.0;
+                break;
+            case 6:
+                scale = -log10two / 3.0;
+                break;
+            case 7:
+                scale = -1.0 / std::log2(50000.0);
+                break;
+            case 8:
+                scale = 1.0;
+                break;
+            case 9:
+                scale = ln2;
+                break;
+            case 11:
+                scale = 10.0 * log10two;
+                break;
+            case 12:
+                scale = 2.0 * log10two;
+                break;
+            case 13:
+                scale = 20.0 * log10two;
+                break;
+            case 14:
+                scale = 1.0 / std::log2(3.0);
+                break;
+            case 15:
+                scale = 0.5 * ln2;
+                break;
+            case 29:
+                scale = 2.0 / 3.0 * log10two;
+                offset = -10.7;
+                break;
+            case 30:
+                scale = 2.0 / 3.0 * log10two;
+                offset = -3.2;
+                break;
+            default:
+                return false;
+        }
+        return true;
+    }
+#endif
+
+    /// the number of values processed through all steps at a time
+    constexpr std::size_t bulk_block{512};
+
+    void runProgram(
+        const bulk_program& program,
+        step_kernel kernel,
+        const double* values,
+        double* output,
+        std::size_t elements)
+    {
+        for (std::size_t offset = 0; offset < elements; offset += bulk_block) {
+            const std::size_t block = (std::min)(bulk_block, elements - offset);
+            const double* source = values + offset;
+            if (program.is_equation()) {
+                precise::equations::convert_equnit_to_value(
+                    source, output + offset, block, program.start_base());
+                source = output + offset;
+            }
+            for (int ii = 0; ii < program.size(); ++ii) {
+                kernel(source, output + offset, block, program.steps()[ii]);
+                source = output + offset;
+            }
+            if (program.is_equation()) {
+                precise::equations::convert_value_to_equnit(
+                    source, output + offset, block, program.result_base());
+            }
+        }
+    }
+}  // namespace
+
+void convert(
+    const double* values,
+    double* output,
+    std::size_t elements,
+    const precise_unit& start,
+    const precise_unit& result)
+{
+    const bulk_program program(start, result);
+    if (program.is_identity()) {
+        if (output != values) {
+            std::copy(values, values + elements, output);
+        }
+    } else if (program.is_general()) {
+        for (std::size_t ii = 0; ii < elements; ++ii) {
+            output[ii] = convert(values[ii], start, result);
+        }
+    } else {
+        runProgram(program, activeKernel(), values, output, elements);
+    }
+}
+
+void convert(
+    const float* values,
+    float* output,
+    std::size_t elements,
+    const precise_unit& start,
+    const precise_unit& result)
+{
+    const bulk_program program(start, result);
+    if (program.is_identity()) {
+        if (output != values) {
+            std::copy(values, values + elements, output);
+        }
+    } else if (program.is_general()) {
+        for (std::size_t ii = 0; ii < elements; ++ii) {
+            output[ii] = static_cast<float>(
+                convert(static_cast<double>(values[ii]), start, result));
+        }
+    } else {
+        // the float values are widened so each step rounds as in convert
+        std::array<double, bulk_block> buffer;
+        for (std::size_t offset = 0; offset < elements; offset += bulk_block) {
+            const std::size_t block = (std::min)(bulk_block, elements - offset);
+            for (std::size_t ii = 0; ii < block; ++ii) {
+                buffer[ii] = static_cast<double>(values[offset + ii]);
+            }
+            runProgram(
+                program, activeKernel(), buffer.data(), buffer.data(), block);
+            for (std::size_t ii = 0; ii < block; ++ii) {
+                output[offset + ii] = static_cast<float>(buffer[ii]);
+            }
+        }
+    }
+}
+
+namespace precise {
+    namespace equations {
+        void convert_equnit_to_value(
+            const double* values,
+            double* output,
+            std::size_t elements,
+            const detail::unit_data& UT,
+            eq_accuracy accuracy)
+        {
+            if (!UT.is_equation()) {
+                if (output != values) {
+                    std::copy(values, values + elements, output);
+                }
+                return;
+            }
+#ifdef UNITS_BULK_VECTOR_EXTENSIONS
+            double offset{0.0};
+            double scale{1.0};
+            if (accuracy == eq_accuracy::fast &&
+                exponentialForm(UT, offset, scale)) {
+                activeFastKernels().exp2(
+                    values, output, elements, offset, scale);
+                return;
+            }
+#else
+            (void)accuracy;
+#endif
+            for (std::size_t ii = 0; ii < elements; ++ii) {
+                output[ii] = convert_equnit_to_value(values[ii], UT);
+            }
+        }
+
+        void convert_value_to_equnit(
+            const double* values,
+            double* output,
+            std::size_t elements,
+            const detail::unit_data& UT,
+            eq_accuracy accuracy)
+        {
+            if (!UT.is_equation()) {
+                if (output != values) {
+                    std::copy(values, values + elements, output);
+                }
+                return;
+            }
+#ifdef UNITS_BULK_VECTOR_EXTENSIONS
+            double scale{1.0};
+            double offset{0.0};
+            if (accuracy == eq_accuracy::fast &&
+                logarithmicForm(UT, scale, offset)) {
+                activeFastKernels().log2(
+                    values,
+                    output,
+                    elements,
+                    scale,
+                    offset,
+                    custom::eq_type(UT) < 16);
+                return;
+            }
+#else
+            (void)accuracy;
+#endif
+            for (std::size_t ii = 0; ii < elements; ++ii) {
+                output[ii] = convert_value_to_equnit(values[ii], UT);
+            }
+        }
+    }  // namespace equations
+}  // namespace precise
+
+#ifdef ENABLE_UNIT_TESTING
+namespace detail {
+    namespace testing {
+        bool testBulkKernel(
+            int kernel,
+            const double* values,
+            double* output,
+            std::size_t elements,
+            const precise_unit& start,
+            const precise_unit& result)
+        {
+            const bulk_program program(start, result);
+            if (program.is_identity() || program.is_general()) {
+                return false;
+            }
+            step_kernel selected{nullptr};
+            switch (kernel) {
+                case 0:
+                    selected = &scalarKernel;
+                    break;
+#ifdef UNITS_BULK_SSE2
+                case 1:
+                    selected = &sse2Kernel;
+                    break;
+#endif
+#ifdef UNITS_BULK_X86_DISPATCH
+                case 2:
+                    if (__builtin_cpu_supports("avx2")) {
+                        selected = &avx2Kernel;
+                    }
+                    break;
+                case 3:
+                    if (__builtin_cpu_supports("avx512f")) {
+                        selected = &avx512Kernel;
+                    }
+                    break;
+#endif
+                default:
+                    break;
+            }
+            if (selected == nullptr) {
+                return false;
+            }
+            runProgram(program, selected, values, output, elements);
+            return true;
+        }
+    }  // namespace testing
+}  // namespace detail
+#endif
+
+}  // namespace UNITS_NAMESPACE
@@ -0,0 +1,52 @@
+/*
+Copyright (c) 2019-2022,
+Lawrence Livermore National Security, LLC;
+See the top-level NOTICE for additional details. All rights reserved.
+SPDX-License-Identifier: BSD-3-Clause
+*/
+#pragma once
+
+/** @file
+internal lookup of units in the sorted code tables used by the x12, dod, and
+r20 conversions, not part of the installed headers
+*/
+
+#include "units.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <tuple>
+#include <utility>
+
+namespace UNITS_NAMESPACE {
+/// a code table entry with the code, a description, and the unit
+using unitD = std::tuple<const char*, const char*, precise_unit>;
+
+namespace detail {
+    /// check if a null terminated code sorts before a character buffer
+    inline bool codeLess(
+        const unitD& u_set,
+        const std::pair<const char*, std::size_t>& val)
+    {
+        return (strncmp(std::get<0>(u_set), val.first, val.second) < 0);
+    }
+
+    /// find the unit for a code in a sorted code table
+    template<std::size_t N>
+    precise_unit findCodeUnit(
+        const std::array<unitD, N>& units,
+        const char* code,
+        std::size_t length)
+    {
+        auto key = std::make_pair(code, length);
+        auto ind =
+            std::lower_bound(units.begin(), units.end(), key, codeLess);
+        if (ind != units.end() && strlen(std::get<0>(*ind)) == length &&
+            strncmp(std::get<0>(*ind), code, length) == 0) {
+            return std::get<2>(*ind);
+        }
+        return precise::error;
+    }
+}  // namespace detail
+}  // namespace UNITS_NAMESPACE
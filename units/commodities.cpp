@@ -11,8 +11,7 @@ SPDX-License-Identifier: BSD-3-Clause
 #include <atomic>
 #include <cctype>
 #include <cstring>
-#include <iomanip>
-#include <iostream>
+#include <mutex>
 #include <sstream>
 #include <string>
 #include <tuple>
@@ -97,179 +96,190 @@ enum commodity : std::uint32_t
 namespace UNITS_NAMESPACE {
 namespace commodities {
     using commodityMap = std::unordered_map<std::uint32_t, const char*>;
-    static const commodityMap commodity_names{
-        {water, "water"},
-        // metals
-        {gold, "gold"},
-        {copper, "copper"},
-        {silver, "silver"},
-        {platinum, "platinum"},
-        {palladium, "palladium"},
-        {zinc, "zinc"},
-        {tin, "tin"},
-        {lead, "lead"},
-        {aluminum, "aluminum"},
-        {alluminum_alloy, "alluminum_alloy"},
-        {nickel, "nickel"},
-        {cobolt, "cobolt"},
-        {molybdenum, "molybdenum"},
+    // the map is generated on first use
+    static const commodityMap& commodityNames()
+    {
+        static const commodityMap names{
+            {water, "water"},
+            // metals
+            {gold, "gold"},
+            {copper, "copper"},
+            {silver, "silver"},
+            {platinum, "platinum"},
+            {palladium, "palladium"},
+            {zinc, "zinc"},
+            {tin, "tin"},
+            {lead, "lead"},
+            {aluminum, "aluminum"},
+            {alluminum_alloy, "alluminum_alloy"},
+            {nickel, "nickel"},
+            {cobolt, "cobolt"},
+            {molybdenum, "molybdenum"},
 
-        // energy
-        {oil, "oil"},
-        {heat_oil, "heat_oil"},
-        {nat_gas, "nat_gas"},
-        {brent_crude, "brent_crude"},
-        {ethanol, "ethanol"},
-        {propane, "propane"},
-        // grains
-        {wheat, "wheat"},
-        {corn, "corn"},
-        {soybeans, "soybeans"},
-        {soybean_meal, "soybean_meal"},
-        {soybean_oil, "soybean_oil"},
-        {oats, "oats"},
-        {rice, "rice"},
-        {red_wheat, "red_wheat"},
-        {spring_wheat, "spring_wheat"},
-        {canola, "canola"},
-        {rough_rice, "rough_rice"},
-        {rapeseed, "rapeseed"},
-        {adzuci, "adzuci"},
-        {barley, "barley"},
-        // meats
-        {live_cattle, "live_cattle"},
-        {feeder_cattle, "feeder_cattle"},
-        {lean_hogs, "lean_hogs"},
-        {milk, "milk"},
+            // energy
+            {oil, "oil"},
+            {heat_oil, "heat_oil"},
+            {nat_gas, "nat_gas"},
+            {brent_crude, "brent_crude"},
+            {ethanol, "ethanol"},
+            {propane, "propane"},
+            // grains
+            {wheat, "wheat"},
+            {corn, "corn"},
+            {soybeans, "soybeans"},
+            {soybean_meal, "soybean_meal"},
+            {soybean_oil, "soybean_oil"},
+            {oats, "oats"},
+            {rice, "rice"},
+            {red_wheat, "red_wheat"},
+            {spring_wheat, "spring_wheat"},
+            {canola, "canola"},
+            {rough_rice, "rough_rice"},
+            {rapeseed, "rapeseed"},
+            {adzuci, "adzuci"},
+            {barley, "barley"},
+            // meats
+            {live_cattle, "live_cattle"},
+            {feeder_cattle, "feeder_cattle"},
+            {lean_hogs, "lean_hogs"},
+            {milk, "milk"},
 
-        // soft
-        {cotton, "cotton"},
-        {orange_juice, "orange_juice"},
-        {sugar, "sugar"},
-        {sugar_11, "sugar_11"},
-        {sugar_14, "sugar_14"},
-        {coffee, "coffee"},
-        {cocoa, "cocoa"},
-        {palm_oil, "palm_oil"},
-        {rubber, "rubber"},
-        {wool, "wool"},
-        {lumber, "lumber"},
+            // soft
+            {cotton, "cotton"},
+            {orange_juice, "orange_juice"},
+            {sugar, "sugar"},
+            {sugar_11, "sugar_11"},
+            {sugar_14, "sugar_14"},
+            {coffee, "coffee"},
+            {cocoa, "cocoa"},
+            {palm_oil, "palm_oil"},
+            {rubber, "rubber"},
+            {wool, "wool"},
+            {lumber, "lumber"},
 
-        // other common unit blocks
-        {people, "people"},
-        {particles, "particles"},
-        {vehicle, "vehicle"},
+            // other common unit blocks
+            {people, "people"},
+            {particles, "particles"},
+            {vehicle, "vehicle"},
 
-        // clinical
-        {tissue, "tissue"},
-        {cell, "cell"},
-        {embryo, "embryo"},
-        {Hahnemann, "Hahnemann"},
-        {Korsakov, "Korsakov"},
-        {creatinine, "creatinine"},
-        {protein, "protein"},
+            // clinical
+            {tissue, "tissue"},
+            {cell, "cell"},
+            {embryo, "embryo"},
+            {Hahnemann, "Hahnemann"},
+            {Korsakov, "Korsakov"},
+            {creatinine, "creatinine"},
+            {protein, "protein"},
 
-        {pixel, "pixel"},
-        {voxel, "voxel"},
-        {1073741824, "cxcomm[1073741824]"},  // this is a _____ string commodity
-                                             // that might somehow get generated
-    };
+            {pixel, "pixel"},
+            {voxel, "voxel"},
+            {1073741824,
+             "cxcomm[1073741824]"},  // this is a _____ string commodity that
+                                     // might somehow get generated
+        };
+        return names;
+    }
 
     using commodityNameMap = std::unordered_map<std::string, std::uint32_t>;
-    static const commodityNameMap commodity_codes{
-        {"_", 0},  // null commodity code, would cause some screwy things with
-                   // the strings
-        {"__", 0},  // null commodity code, would cause some screwy things with
-                    // the strings
-        {"___", 0},  // null commodity code, would cause some screwy things with
-                     // the strings
-        {"____", 0},  // null commodity code, would cause some screwy things
-                      // with the strings
-        {"_____", 0},  // null commodity code, would cause some screwy things
-                       // with the strings
-        {"water", water},
-        // metals
-        {"gold", gold},
-        {"copper", copper},
-        {"silver", silver},
-        {"platinum", platinum},
-        {"palladium", palladium},
-        {"zinc", zinc},
-        {"tin", tin},
-        {"lead", lead},
-        {"aluminum", aluminum},
-        {"alluminum_alloy", alluminum_alloy},
-        {"nickel", nickel},
-        {"cobolt", cobolt},
-        {"molybdenum", molybdenum},
-        {"carbon", carbon},
+    // the map is generated on first use
+    static const commodityNameMap& commodityCodes()
+    {
+        static const commodityNameMap codes{
+            {"_", 0},  // null commodity code, would cause some
+                       // screwy things with the strings
+            {"__", 0},  // null commodity code, would cause some
+                        // screwy things with the strings
+            {"___", 0},  // null commodity code, would cause some
+                         // screwy things with the strings
+            {"____", 0},  // null commodity code, would cause some
+                          // screwy things with the strings
+            {"_____", 0},  // null commodity code, would cause some
+                           // screwy things with the strings
+            {"water", water},
+            // metals
+            {"gold", gold},
+            {"copper", copper},
+            {"silver", silver},
+            {"platinum", platinum},
+            {"palladium", palladium},
+            {"zinc", zinc},
+            {"tin", tin},
+            {"lead", lead},
+            {"aluminum", aluminum},
+            {"alluminum_alloy", alluminum_alloy},
+            {"nickel", nickel},
+            {"cobolt", cobolt},
+            {"molybdenum", molybdenum},
+            {"carbon", carbon},
 
-        // energy
-        {"oil", oil},
-        {"heat_oil", heat_oil},
-        {"nat_gas", nat_gas},
-        {"brent_crude", brent_crude},
-        {"ethanol", ethanol},
-        {"propane", propane},
-        // grains
-        {"wheat", wheat},
-        {"corn", corn},
-        {"soybeans", soybeans},
-        {"soybean_meal", soybean_meal},
-        {"soybean_oil", soybean_oil},
-        {"oats", oats},
-        {"rice", rice},
-        {"red_wheat", red_wheat},
-        {"spring_wheat", spring_wheat},
-        {"canola", canola},
-        {"rough_rice", rough_rice},
-        {"rapeseed", rapeseed},
-        {"adzuci", adzuci},
-        {"barley", barley},
-        // meats
-        {"live_cattle", live_cattle},
-        {"feeder_cattle", feeder_cattle},
-        {"lean_hogs", lean_hogs},
-        {"milk", milk},
+            // energy
+            {"oil", oil},
+            {"heat_oil", heat_oil},
+            {"nat_gas", nat_gas},
+            {"brent_crude", brent_crude},
+            {"ethanol", ethanol},
+            {"propane", propane},
+            // grains
+            {"wheat", wheat},
+            {"corn", corn},
+            {"soybeans", soybeans},
+            {"soybean_meal", soybean_meal},
+            {"soybean_oil", soybean_oil},
+            {"oats", oats},
+            {"rice", rice},
+            {"red_wheat", red_wheat},
+            {"spring_wheat", spring_wheat},
+            {"canola", canola},
+            {"rough_rice", rough_rice},
+            {"rapeseed", rapeseed},
+            {"adzuci", adzuci},
+            {"barley", barley},
+            // meats
+            {"live_cattle", live_cattle},
+            {"feeder_cattle", feeder_cattle},
+            {"lean_hogs", lean_hogs},
+            {"milk", milk},
 
-        // soft
-        {"cotton", cotton},
-        {"orange_juice", orange_juice},
-        {"sugar", sugar},
-        {"sugar_11", sugar_11},
-        {"sugar_14", sugar_14},
-        {"coffee", coffee},
-        {"cocoa", cocoa},
-        {"palm_oil", palm_oil},
-        {"rubber", rubber},
-        {"wool", wool},
-        {"lumber", lumber},
+            // soft
+            {"cotton", cotton},
+            {"orange_juice", orange_juice},
+            {"sugar", sugar},
+            {"sugar_11", sugar_11},
+            {"sugar_14", sugar_14},
+            {"coffee", coffee},
+            {"cocoa", cocoa},
+            {"palm_oil", palm_oil},
+            {"rubber", rubber},
+            {"wool", wool},
+            {"lumber", lumber},
 
-        // other common unit blocks
-        {"people", people},
-        {"particles", particles},
-        {"cars", vehicle},
-        {"vehicle", vehicle},
-        // clinical
-        {"tissue", tissue},
-        {"cell", cell},
-        {"cells", cell},
-        {"embryo", embryo},
-        {"hahnemann", Hahnemann},
-        {"korsakov", Korsakov},
-        {"protein", protein},
-        {"creatinine", creatinine},
-        {"prot", protein},
-        {"creat", creatinine},
-        // computer
-        {"voxel", voxel},
-        {"pixel", pixel},
-        {"vox", voxel},
-        {"pix", pixel},
-        {"dot", pixel},
-        {"error", errors},
-        {"errors", errors},
-    };
+            // other common unit blocks
+            {"people", people},
+            {"particles", particles},
+            {"cars", vehicle},
+            {"vehicle", vehicle},
+            // clinical
+            {"tissue", tissue},
+            {"cell", cell},
+            {"cells", cell},
+            {"embryo", embryo},
+            {"hahnemann", Hahnemann},
+            {"korsakov", Korsakov},
+            {"protein", protein},
+            {"creatinine", creatinine},
+            {"prot", protein},
+            {"creat", creatinine},
+            // computer
+            {"voxel", voxel},
+            {"pixel", pixel},
+            {"vox", voxel},
+            {"pix", pixel},
+            {"dot", pixel},
+            {"error", errors},
+            {"errors", errors},
+        };
+        return codes;
+    }
 }  // namespace commodities
 
 namespace hashcodes {
@@ -294,13 +304,29 @@ static std::atomic<bool> allowCustomCommodities{true};
 void disableCustomCommodities()
 {
     allowCustomCommodities.store(false);
+    clearParseCache();
+    clearToStringCache();
 }
 void enableCustomCommodities()
 {
     allowCustomCommodities.store(true);
+    clearParseCache();
+    clearToStringCache();
 }
-static commodities::commodityNameMap customCommodityCodes;
-static std::unordered_map<std::uint32_t, std::string> customCommodityNames;
+// the custom commodity maps are created on first use
+static commodities::commodityNameMap& customCommodityCodes()
+{
+    static commodities::commodityNameMap codes;
+    return codes;
+}
+static std::unordered_map<std::uint32_t, std::string>& customCommodityNames()
+{
+    static std::unordered_map<std::uint32_t, std::string> names;
+    return names;
+}
+// custom commodities can be added while strings are interpreted so the maps
+// need protection if strings are interpreted on multiple threads
+static std::mutex customCommodityLock;
 /// remove some escaped characters from a string mainly the escape character and
 /// (){}[]
 static void removeEscapeSequences(std::string& str)
@@ -330,16 +356,19 @@ uint32_t getCommodity(std::string comm)
     removeEscapeSequences(comm);
     std::transform(comm.begin(), comm.end(), comm.begin(), ::tolower);
     if (allowCustomCommodities.load(std::memory_order_acquire)) {
-        if (!customCommodityCodes.empty()) {
-            auto fnd2 = customCommodityCodes.find(comm);
-            if (fnd2 != customCommodityCodes.end()) {
+        std::lock_guard<std::mutex> lock(customCommodityLock);
+        const auto& customCodes = customCommodityCodes();
+        if (!customCodes.empty()) {
+            auto fnd2 = customCodes.find(comm);
+            if (fnd2 != customCodes.end()) {
                 return fnd2->second;
             }
         }
     }
 
-    auto fnd = commodities::commodity_codes.find(comm);
-    if (fnd != commodities::commodity_codes.end()) {
+    const auto& commodityCodes = commodities::commodityCodes();
+    auto fnd = commodityCodes.find(comm);
+    if (fnd != commodityCodes.end()) {
         return fnd->second;
     }
 
@@ -374,15 +403,18 @@ uint32_t getCommodity(std::string comm)
 std::string getCommodityName(std::uint32_t commodity)
 {
     if (allowCustomCommodities.load(std::memory_order_acquire)) {
-        if (!customCommodityNames.empty()) {
-            auto fnd2 = customCommodityNames.find(commodity);
-            if (fnd2 != customCommodityNames.end()) {
+        std::lock_guard<std::mutex> lock(customCommodityLock);
+        const auto& customNames = customCommodityNames();
+        if (!customNames.empty()) {
+            auto fnd2 = customNames.find(commodity);
+            if (fnd2 != customNames.end()) {
                 return fnd2->second;
             }
         }
     }
-    auto fnd = commodities::commodity_names.find(commodity);
-    if (fnd != commodities::commodity_names.end()) {
+    const auto& commodityNames = commodities::commodityNames();
+    auto fnd = commodityNames.find(commodity);
+    if (fnd != commodityNames.end()) {
         return fnd->second;
     }
 
@@ -406,14 +438,27 @@ void addCustomCommodity(std::string comm, std::uint32_t code)
 {
     if (allowCustomCommodities.load()) {
         std::transform(comm.begin(), comm.end(), comm.begin(), ::tolower);
-        customCommodityNames.emplace(code, comm);
-        customCommodityCodes.emplace(comm, code);
+        bool added{false};
+        {
+            std::lock_guard<std::mutex> lock(customCommodityLock);
+            added = customCommodityNames().emplace(code, comm).second;
+            added = customCommodityCodes().emplace(comm, code).second || added;
+        }
+        if (added) {
+            clearParseCache();
+            clearToStringCache();
+        }
     }
 }
 
 void clearCustomCommodities()
 {
-    customCommodityNames.clear();
-    customCommodityCodes.clear();
+    {
+        std::lock_guard<std::mutex> lock(customCommodityLock);
+        customCommodityNames().clear();
+        customCommodityCodes().clear();
+    }
+    clearParseCache();
+    clearToStringCache();
 }
 }  // namespace UNITS_NAMESPACE
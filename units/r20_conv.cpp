@@ -4,16 +4,13 @@ Lawrence Livermore National Security, LLC;
 See the top-level NOTICE for additional details. All rights reserved.
 SPDX-License-Identifier: BSD-3-Clause
 */
+#include "code_tables.hpp"
 #include "units.hpp"
 
-#include <algorithm>
 #include <array>
-#include <cstring>
-#include <tuple>
 #include <unordered_map>
 
 namespace UNITS_NAMESPACE {
-using unitD = std::tuple<const char*, const char*, precise_unit>;
 static UNITS_CPP14_CONSTEXPR_OBJECT std::array<unitD, 2088> r20_units = {{
     unitD{"05", "lift", precise::one / precise::count},
     unitD{"06", "small spray", precise::one / precise::count},
@@ -3013,17 +3010,13 @@ static UNITS_CPP14_CONSTEXPR_OBJECT std::array<unitD, 2088> r20_units = {{
 
 precise_unit r20_unit(const std::string& r20_string)
 {
-    auto ind = std::lower_bound(
-        r20_units.begin(),
-        r20_units.end(),
-        r20_string,
-        [](const unitD& u_set, const std::string& val) {
-            return (strcmp(std::get<0>(u_set), val.c_str()) < 0);
-        });
-    if (strcmp(std::get<0>(*ind), r20_string.c_str()) == 0) {
-        return std::get<2>(*ind);
-    }
-    return precise::error;
+    return detail::findCodeUnit(
+        r20_units, r20_string.c_str(), r20_string.size());
+}
+
+precise_unit r20_unit(const char* r20_string, std::size_t length)
+{
+    return detail::findCodeUnit(r20_units, r20_string, length);
 }
 
 }  // namespace UNITS_NAMESPACE
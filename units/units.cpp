@@ -10,23 +10,45 @@ SPDX-License-Identifier: BSD-3-Clause
 #include <algorithm>
 #include <array>
 #include <atomic>
+#include <bitset>
 #include <cctype>
+#include <chrono>
+#include <cstdio>
 #include <cstring>
+#include <exception>
 #include <fstream>
-#include <iomanip>
-#include <iostream>
 #include <limits>
+#include <memory>
+#include <mutex>
 #include <sstream>
+#include <stdexcept>
 #include <string>
+#include <system_error>
+#include <thread>
 #include <tuple>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
+#if defined(__SSE2__) || defined(_M_X64) ||                                  \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define UNITS_SSE2_CHARACTER_SCAN
+#endif
+
 #if (__cplusplus >= 201703L) || (defined(_MSVC_LANG) && _MSVC_LANG >= 201703)
 #ifndef UNITS_CONSTEXPR_IF_SUPPORTED
 #define UNITS_CONSTEXPR_IF_SUPPORTED
 #endif
+#if defined(__has_include)
+#if __has_include(<charconv>)
+#include <charconv>
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+#define UNITS_HAS_FLOAT_FROM_CHARS
+#endif
+#endif
+#endif
 #endif
 
 /** @file
@@ -140,22 +162,9 @@ static int order(const unit& val)
     return order;
 }
 
-// NOTE no unit strings with '/' in it this can cause issues when converting to
-// string with out-of-order operations
-using umap = std::unordered_map<unit, const char*>;
-
-static umap getDefinedBaseUnitNames()
-{
-    umap definedNames;
-    for (const auto& name : defined_unit_names) {
-        if (name.second != nullptr) {
-            definedNames.emplace(name.first, name.second);
-        }
-    }
-    return definedNames;
-}
-
-static const umap base_unit_names = getDefinedBaseUnitNames();
+/** find the name of a unit in the defined unit names
+@return the table entry for the unit or nullptr if it has no name*/
+static const std::pair<unit, const char*>* findUnitName(const unit& un);
 
 using ustr = std::pair<precise_unit, const char*>;
 // units to divide into tests to explore common multiplier units
@@ -206,11 +215,12 @@ static UNITS_CPP14_CONSTEXPR_OBJECT std::array<ustr, 4> creduceUnits{
      ustr{precise::W, "W^-1*"},
      ustr{precise::W.inv(), "W*"}}};
 
-// thought about making this constexpr array, but the problem is that runtime
-// floats are not guaranteed to be the same as compile time floats so really
-// this map needs to be generated at run-time once multiplier prefixes commonly
-// used
-static const std::unordered_map<float, char> si_prefixes{
+using prefix_pair = std::pair<float, char>;
+// multipliers for the SI prefixes, the reciprocal of the inverse is not always
+// the same float as the multiplier itself so both are listed.  The table is
+// constant initialized so the values are the same as the compiler generates
+// for the unit definitions
+static UNITS_CPP14_CONSTEXPR_OBJECT std::array<prefix_pair, 40> si_prefixes{{
     {0.001F, 'm'},        {1.0F / 1000.0F, 'm'},
     {1000.0F, 'k'},       {1.0F / 0.001F, 'k'},
     {1e-6F, 'u'},         {1.0F / 1e6F, 'u'},
@@ -228,7 +238,18 @@ static const std::unordered_map<float, char> si_prefixes{
     {1e18F, 'E'},         {1.0F / 1e-18F, 'E'},
     {1e21F, 'Z'},         {1.0F / 1e-21F, 'Z'},
     {1e24F, 'Y'},         {1.0F / 1e-24F, 'Y'},
-};
+}};
+
+/// get the SI prefix character for a multiplier or '\0' if there is none
+static char getSIprefix(float multiplier)
+{
+    for (const auto& prefix : si_prefixes) {
+        if (prefix.first == multiplier) {
+            return prefix.second;
+        }
+    }
+    return '\0';
+}
 
 // check if the character is something that could begin a number
 static inline bool isNumericalStartCharacter(char X)
@@ -249,9 +270,14 @@ static precise_unit unit_from_string_internal(
     std::string unit_string,
     std::uint32_t match_flags);
 
+// forward declaration of the internal measurement from_string function
+static precise_measurement measurement_from_string_internal(
+    std::string measurement_string,
+    std::uint32_t match_flags);
+
 // forward declaration of the quick find function
 static precise_unit
-    unit_quick_match(std::string unit_string, std::uint32_t match_flags);
+    unit_quick_match(const std::string& unit_string, std::uint32_t match_flags);
 // forward declaration of the function to check for custom units
 static precise_unit checkForCustomUnit(const std::string& unit_string);
 
@@ -295,6 +321,218 @@ static bool ReplaceStringInPlace(
     return changed;
 }
 
+/// classes of characters which trigger the various string cleaning passes
+enum character_class : std::uint32_t {
+    high_bit_characters = 1U,  //!< extended ascii or utf-8 sequences
+    ampersand_characters = 2U,  //!< '&' html entities
+    space_characters = 4U,  //!< whitespace and embedded null characters
+    bracket_characters = 8U,  //!< ()[]{}<>
+    caret_characters = 16U,  //!< '^' power operations
+    digit_characters = 32U,  //!< 0-9
+};
+
+static std::uint32_t characterClass(char c)
+{
+    switch (c) {
+        case '&':
+            return ampersand_characters;
+        case ' ':
+        case '\t':
+        case '\n':
+        case '\r':
+        case '\0':
+            return space_characters;
+        case '(':
+        case ')':
+        case '[':
+        case ']':
+        case '{':
+        case '}':
+        case '<':
+        case '>':
+            return bracket_characters;
+        case '^':
+            return caret_characters;
+        default:
+            if (c >= '0' && c <= '9') {
+                return digit_characters;
+            }
+            return ((static_cast<std::uint8_t>(c) & 0x80U) != 0) ?
+                high_bit_characters :
+                0U;
+    }
+}
+
+/** get a bitmask of the character classes present in a string, the
+classification is vectorized when SSE2 is available*/
+static std::uint32_t characterClasses(const char* str, std::size_t length)
+{
+    std::uint32_t classes{0U};
+    std::size_t pos{0};
+#ifdef UNITS_SSE2_CHARACTER_SCAN
+    if (length >= 16) {
+        auto highBit = _mm_setzero_si128();
+        auto amp = _mm_setzero_si128();
+        auto space = _mm_setzero_si128();
+        auto bracket = _mm_setzero_si128();
+        auto caret = _mm_setzero_si128();
+        auto digit = _mm_setzero_si128();
+        const auto zero = _mm_setzero_si128();
+        for (; pos + 16 <= length; pos += 16) {
+            auto block = _mm_loadu_si128(
+                reinterpret_cast<const __m128i*>(str + pos));
+            highBit = _mm_or_si128(highBit, block);
+            amp = _mm_or_si128(
+                amp, _mm_cmpeq_epi8(block, _mm_set1_epi8('&')));
+            auto sp = _mm_or_si128(
+                _mm_cmpeq_epi8(block, _mm_set1_epi8(' ')),
+                _mm_cmpeq_epi8(block, zero));
+            // '\t', '\n', and '\r' are 0x09, 0x0A, and 0x0D
+            auto ctrl = _mm_or_si128(
+                _mm_cmpeq_epi8(block, _mm_set1_epi8('\t')),
+                _mm_cmpeq_epi8(block, _mm_set1_epi8('\n')));
+            ctrl = _mm_or_si128(
+                ctrl, _mm_cmpeq_epi8(block, _mm_set1_epi8('\r')));
+            space = _mm_or_si128(space, _mm_or_si128(sp, ctrl));
+            // '(' and ')' differ only in the low bit, '[' ']' '{' '}' map to
+            // '{' and '}' with 0x20 set, and '<' '>' differ only in 0x02
+            auto br = _mm_cmpeq_epi8(
+                _mm_or_si128(block, _mm_set1_epi8(0x01)),
+                _mm_set1_epi8(')'));
+            auto cb = _mm_or_si128(block, _mm_set1_epi8(0x20));
+            br = _mm_or_si128(br, _mm_cmpeq_epi8(cb, _mm_set1_epi8('{')));
+            br = _mm_or_si128(br, _mm_cmpeq_epi8(cb, _mm_set1_epi8('}')));
+            br = _mm_or_si128(
+                br,
+                _mm_cmpeq_epi8(
+                    _mm_or_si128(block, _mm_set1_epi8(0x02)),
+                    _mm_set1_epi8('>')));
+            bracket = _mm_or_si128(bracket, br);
+            caret = _mm_or_si128(
+                caret, _mm_cmpeq_epi8(block, _mm_set1_epi8('^')));
+            // high bit bytes are negative so the signed compare excludes them
+            digit = _mm_or_si128(
+                digit,
+                _mm_and_si128(
+                    _mm_cmpgt_epi8(block, _mm_set1_epi8('0' - 1)),
+                    _mm_cmplt_epi8(block, _mm_set1_epi8('9' + 1))));
+        }
+        if (_mm_movemask_epi8(highBit) != 0) {
+            classes |= high_bit_characters;
+        }
+        if (_mm_movemask_epi8(amp) != 0) {
+            classes |= ampersand_characters;
+        }
+        if (_mm_movemask_epi8(space) != 0) {
+            classes |= space_characters;
+        }
+        if (_mm_movemask_epi8(bracket) != 0) {
+            classes |= bracket_characters;
+        }
+        if (_mm_movemask_epi8(caret) != 0) {
+            classes |= caret_characters;
+        }
+        if (_mm_movemask_epi8(digit) != 0) {
+            classes |= digit_characters;
+        }
+    }
+#endif
+    for (; pos < length; ++pos) {
+        classes |= characterClass(str[pos]);
+    }
+    return classes;
+}
+
+static std::uint32_t characterClasses(const std::string& str)
+{
+    return characterClasses(str.data(), str.size());
+}
+
+static double parseDouble(
+    const char* str,
+    std::size_t length,
+    std::size_t& index) noexcept;
+
+/// the buffer size needed by formatNumber
+static constexpr std::size_t numberBufferSize{32};
+
+/** write the shortest of the 15, 16, or 17 significant digit representations
+of a number which converts back to the same value
+@details the output does not depend on the current locale and does not
+allocate, the buffer must hold at least numberBufferSize characters
+@return the number of characters written*/
+static std::size_t formatNumber(double value, char* buffer) noexcept
+{
+    if (value == std::trunc(value) && std::fabs(value) < 1e15) {
+        // integers with at most 15 digits are written in full by %.15g
+        char digits[16];
+        std::size_t ndigits{0};
+        auto integer = static_cast<std::int64_t>(std::fabs(value));
+        do {
+            digits[ndigits++] = static_cast<char>('0' + integer % 10);
+            integer /= 10;
+        } while (integer > 0);
+        std::size_t length{0};
+        if (std::signbit(value)) {
+            buffer[length++] = '-';
+        }
+        while (ndigits > 0) {
+            buffer[length++] = digits[--ndigits];
+        }
+        return length;
+    }
+#ifdef UNITS_HAS_FLOAT_FROM_CHARS
+    // the feature test for from_chars also covers to_chars.  No precision
+    // below the length of the shortest round trip representation can work
+    auto shortest = std::to_chars(
+        buffer,
+        buffer + numberBufferSize,
+        value,
+        std::chars_format::scientific);
+    int minimum{0};
+    for (auto cptr = buffer; cptr != shortest.ptr && *cptr != 'e'; ++cptr) {
+        if (isDigitCharacter(*cptr)) {
+            ++minimum;
+        }
+    }
+#else
+    int minimum{15};
+#endif
+    std::size_t length{0};
+    for (int precision = (minimum > 15) ? minimum : 15; precision <= 17;
+         ++precision) {
+#ifdef UNITS_HAS_FLOAT_FROM_CHARS
+        auto res = std::to_chars(
+            buffer,
+            buffer + numberBufferSize,
+            value,
+            std::chars_format::general,
+            precision);
+        length = static_cast<std::size_t>(res.ptr - buffer);
+#else
+        auto written =
+            std::snprintf(buffer, numberBufferSize, "%.*g", precision, value);
+        length = (written > 0) ? static_cast<std::size_t>(written) : 0U;
+        // snprintf uses the decimal point of the current locale
+        for (std::size_t ii = 0; ii < length; ++ii) {
+            auto c = buffer[ii];
+            if (!isDigitCharacter(c) && c != '-' && c != '+' &&
+                (c < 'a' || c > 'z') && (c < 'A' || c > 'Z')) {
+                buffer[ii] = '.';
+            }
+        }
+#endif
+        if (!std::isfinite(value)) {
+            break;
+        }
+        std::size_t index{0};
+        if (parseDouble(buffer, length, index) == value) {
+            break;
+        }
+    }
+    return length;
+}
+
 // Generate an SI prefix or a numerical multiplier string for prepending a unit
 static std::string getMultiplierString(double multiplier, bool numOnly = false)
 {
@@ -302,16 +540,13 @@ static std::string getMultiplierString(double multiplier, bool numOnly = false)
         return std::string{};
     }
     if (!numOnly) {
-        auto si = si_prefixes.find(static_cast<float>(multiplier));
-        if (si != si_prefixes.end()) {
-            return std::string(1, si->second);
+        auto si = getSIprefix(static_cast<float>(multiplier));
+        if (si != '\0') {
+            return std::string(1, si);
         }
     }
-    int P = 18;  // the desired precision
-    std::stringstream ss;
-
-    ss << std::setprecision(P) << multiplier;
-    auto rv = ss.str();
+    char buffer[numberBufferSize];
+    std::string rv(buffer, formatNumber(multiplier, buffer));
     if (rv.size() <= 4) {
         // modify some improper strings that cause issues later on
         // some platforms don't produce these
@@ -633,15 +868,618 @@ static std::string
     return val;
 }
 
+/** hash a string and a set of flags into a 64 bit cache key (FNV-1a)*/
+static std::uint64_t
+    cacheHash(const char* str, std::size_t length, std::uint32_t flags)
+{
+    std::uint64_t hash{14695981039346656037ULL};
+    for (std::size_t ii = 0; ii < length; ++ii) {
+        hash ^= static_cast<unsigned char>(str[ii]);
+        hash *= 1099511628211ULL;
+    }
+    for (int ii = 0; ii < 4; ++ii) {
+        hash ^= (flags >> (8 * ii)) & 0xFFU;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+/** size bounded cache split into independently locked shards
+@details entries are located by a precomputed 64 bit hash and verified with a
+key comparison so lookups do not need to construct a key object.  A generation
+counter prevents results computed before an invalidation from being stored
+after it*/
+template<typename KEY, typename VALUE>
+class ShardedCache {
+  public:
+    /// set the total number of entries allowed, 0 disables the cache
+    void setCapacity(std::size_t maxEntries)
+    {
+        shardCapacity.store(
+            (maxEntries == 0) ? 0 : (maxEntries + shardCount - 1) / shardCount,
+            std::memory_order_release);
+        if (maxEntries == 0) {
+            clear();
+        }
+    }
+    bool enabled() const
+    {
+        return shardCapacity.load(std::memory_order_acquire) > 0;
+    }
+    std::uint64_t generation() const
+    {
+        return currentGeneration.load(std::memory_order_acquire);
+    }
+    /// find a value, the match function verifies the stored key
+    template<typename MATCH>
+    bool find(std::uint64_t hash, MATCH match, VALUE& value)
+    {
+        return visit(
+            hash, match, [&value](const VALUE& stored) { value = stored; });
+    }
+    /** find a value and pass it to a visitor while the shard is locked so it
+    can be used without a copy*/
+    template<typename MATCH, typename VISITOR>
+    bool visit(std::uint64_t hash, MATCH match, VISITOR visitor)
+    {
+        auto& shard = shards[hash % shardCount];
+        {
+            std::lock_guard<std::mutex> lock(shard.lock);
+            auto fnd = shard.entries.find(hash);
+            if (fnd != shard.entries.end() && match(fnd->second.first)) {
+                visitor(fnd->second.second);
+                hits.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        misses.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    /// store a value if no invalidation happened since startGeneration
+    void insert(
+        std::uint64_t hash,
+        KEY key,
+        const VALUE& value,
+        std::uint64_t startGeneration)
+    {
+        auto capacity = shardCapacity.load(std::memory_order_acquire);
+        if (capacity == 0) {
+            return;
+        }
+        auto& shard = shards[hash % shardCount];
+        std::lock_guard<std::mutex> lock(shard.lock);
+        if (startGeneration != generation()) {
+            return;
+        }
+        if (shard.entries.size() >= capacity &&
+            shard.entries.find(hash) == shard.entries.end()) {
+            shard.entries.erase(shard.entries.begin());
+        }
+        shard.entries[hash] = std::make_pair(std::move(key), value);
+    }
+    /// remove all entries and reject results computed before the call
+    void clear()
+    {
+        currentGeneration.fetch_add(1, std::memory_order_acq_rel);
+        for (auto& shard : shards) {
+            std::lock_guard<std::mutex> lock(shard.lock);
+            shard.entries.clear();
+        }
+    }
+    cache_statistics statistics()
+    {
+        cache_statistics stats;
+        stats.hits = hits.load(std::memory_order_relaxed);
+        stats.misses = misses.load(std::memory_order_relaxed);
+        stats.capacity =
+            shardCapacity.load(std::memory_order_acquire) * shardCount;
+        for (auto& shard : shards) {
+            std::lock_guard<std::mutex> lock(shard.lock);
+            stats.entries += shard.entries.size();
+        }
+        return stats;
+    }
+
+  private:
+    static constexpr std::size_t shardCount{16};
+    struct Shard {
+        std::mutex lock;
+        std::unordered_map<std::uint64_t, std::pair<KEY, VALUE>> entries;
+    };
+    std::array<Shard, shardCount> shards;
+    std::atomic<std::size_t> shardCapacity{0};
+    std::atomic<std::uint64_t> currentGeneration{0};
+    std::atomic<std::uint64_t> hits{0};
+    std::atomic<std::uint64_t> misses{0};
+};
+
+using parse_cache_key = std::pair<std::string, std::uint32_t>;
+
+// the caches are created on first use so loading the library does not
+// construct them
+static ShardedCache<parse_cache_key, precise_unit>& unitParseCache()
+{
+    static ShardedCache<parse_cache_key, precise_unit> cache;
+    return cache;
+}
+
+static ShardedCache<parse_cache_key, precise_measurement>&
+    measurementParseCache()
+{
+    static ShardedCache<parse_cache_key, precise_measurement> cache;
+    return cache;
+}
+
+void enableParseCache(std::size_t maxEntries)
+{
+    unitParseCache().setCapacity(maxEntries);
+    measurementParseCache().setCapacity(maxEntries);
+}
+
+void disableParseCache()
+{
+    enableParseCache(0);
+}
+
+void clearParseCache()
+{
+    unitParseCache().clear();
+    measurementParseCache().clear();
+}
+
+cache_statistics getParseCacheStatistics()
+{
+    auto stats = unitParseCache().statistics();
+    auto mstats = measurementParseCache().statistics();
+    stats.hits += mstats.hits;
+    stats.misses += mstats.misses;
+    stats.entries += mstats.entries;
+    stats.capacity += mstats.capacity;
+    return stats;
+}
+
+/// the exact identity of a unit and the flags used to generate its string
+using unit_string_key = std::pair<precise_unit, std::uint32_t>;
+
+static ShardedCache<unit_string_key, std::string>& unitStringCache()
+{
+    static ShardedCache<unit_string_key, std::string> cache;
+    return cache;
+}
+
+/** hash the exact bits of a unit and a set of flags into a cache key*/
+static std::uint64_t unitStringHash(const precise_unit& un, std::uint32_t flags)
+{
+    char bytes[sizeof(double) + 2 * sizeof(std::uint32_t)];
+    auto multiplier = un.multiplier();
+    auto base = un.base_units();
+    auto commodity = un.commodity();
+    std::memcpy(bytes, &multiplier, sizeof(double));
+    std::memcpy(bytes + sizeof(double), &base, sizeof(std::uint32_t));
+    std::memcpy(
+        bytes + sizeof(double) + sizeof(std::uint32_t),
+        &commodity,
+        sizeof(std::uint32_t));
+    return cacheHash(bytes, sizeof(bytes), flags);
+}
+
+/** check if two units are bitwise identical, unlike operator== this does not
+round the multiplier*/
+static bool identicalUnits(const precise_unit& a, const precise_unit& b)
+{
+    auto am = a.multiplier();
+    auto bm = b.multiplier();
+    return a.base_units() == b.base_units() &&
+        a.commodity() == b.commodity() &&
+        std::memcmp(&am, &bm, sizeof(double)) == 0;
+}
+
+void enableToStringCache(std::size_t maxEntries)
+{
+    unitStringCache().setCapacity(maxEntries);
+}
+
+void disableToStringCache()
+{
+    unitStringCache().setCapacity(0);
+}
+
+void clearToStringCache()
+{
+    unitStringCache().clear();
+}
+
+cache_statistics getToStringCacheStatistics()
+{
+    return unitStringCache().statistics();
+}
+
+/// invalidate the caches depending on the user defined units or domain
+static void clearStringCaches()
+{
+    clearParseCache();
+    clearToStringCache();
+}
+
+/** append only table assigning ids to distinct units
+@details the units are stored in chunks which are never moved so lookups in
+either direction only need atomic loads, adding a unit is serialized by a
+mutex*/
+class UnitRegistry {
+  public:
+    UnitRegistry() :
+        slots_(new std::atomic<std::uint16_t>[slotCount]())
+    {
+        for (auto& chunk : chunks_) {
+            chunk.store(nullptr, std::memory_order_relaxed);
+        }
+    }
+    ~UnitRegistry()
+    {
+        for (auto& chunk : chunks_) {
+            delete[] chunk.load(std::memory_order_relaxed);
+        }
+    }
+    UnitRegistry(const UnitRegistry&) = delete;
+    UnitRegistry& operator=(const UnitRegistry&) = delete;
+
+    unit_id find(const precise_unit& un, std::size_t hash) const
+    {
+        auto slot = hash & (slotCount - 1);
+        while (true) {
+            auto entry = slots_[slot].load(std::memory_order_acquire);
+            if (entry == 0U) {
+                return invalid_unit_id;
+            }
+            auto id = static_cast<unit_id>(entry - 1U);
+            // ids are published to the slots after the unit is stored
+            if (identicalUnits(stored(id), un)) {
+                return id;
+            }
+            slot = (slot + 1) & (slotCount - 1);
+        }
+    }
+
+    unit_id insert(const precise_unit& un)
+    {
+        auto hash = static_cast<std::size_t>(unitStringHash(un, 0U));
+        auto id = find(un, hash);
+        if (id != invalid_unit_id) {
+            return id;
+        }
+        std::lock_guard<std::mutex> lock(insertLock_);
+        // another thread may have added the unit before the lock was acquired
+        id = find(un, hash);
+        if (id != invalid_unit_id) {
+            return id;
+        }
+        auto next = count_.load(std::memory_order_relaxed);
+        if (next >= invalid_unit_id) {
+            return invalid_unit_id;
+        }
+        auto& chunk = chunks_[next / chunkSize];
+        auto* entries = chunk.load(std::memory_order_relaxed);
+        if (entries == nullptr) {
+            entries = new precise_unit[chunkSize];
+            chunk.store(entries, std::memory_order_release);
+        }
+        entries[next % chunkSize] = un;
+        count_.store(next + 1, std::memory_order_release);
+
+        auto slot = hash & (slotCount - 1);
+        while (slots_[slot].load(std::memory_order_relaxed) != 0U) {
+            slot = (slot + 1) & (slotCount - 1);
+        }
+        slots_[slot].store(
+            static_cast<std::uint16_t>(next + 1), std::memory_order_release);
+        return static_cast<unit_id>(next);
+    }
+
+    const precise_unit* get(unit_id id) const
+    {
+        if (id >= count_.load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+        return &stored(id);
+    }
+
+    std::size_t size() const { return count_.load(std::memory_order_acquire); }
+
+  private:
+    const precise_unit& stored(unit_id id) const
+    {
+        return chunks_[id / chunkSize].load(
+            std::memory_order_acquire)[id % chunkSize];
+    }
+
+    static constexpr std::size_t chunkSize{256};
+    // twice the maximum number of ids so the table is never more than half full
+    static constexpr std::size_t slotCount{131072};
+
+    /// the id + 1 of the unit in each slot of the hash table, 0 if empty
+    std::unique_ptr<std::atomic<std::uint16_t>[]> slots_;
+    std::array<std::atomic<precise_unit*>, 65536 / chunkSize> chunks_;
+    std::atomic<std::size_t> count_{0};
+    std::mutex insertLock_;
+};
+
+static UnitRegistry& unitRegistry()
+{
+    static UnitRegistry registry;
+    return registry;
+}
+
+unit_id internUnit(const precise_unit& un)
+{
+    return unitRegistry().insert(un);
+}
+
+unit_id getUnitId(const precise_unit& un)
+{
+    return unitRegistry().find(
+        un, static_cast<std::size_t>(unitStringHash(un, 0U)));
+}
+
+precise_unit getInternedUnit(unit_id id)
+{
+    const auto* entry = unitRegistry().get(id);
+    return (entry != nullptr) ? *entry : precise::invalid;
+}
+
+std::size_t getInternedUnitCount()
+{
+    return unitRegistry().size();
+}
+
+static std::atomic<std::uint32_t> parseStepBudget{0U};
+static std::atomic<std::uint64_t> parseBudgetExhausted{0U};
+
+/// the work done by the string conversion active on a thread
+struct parse_work {
+    std::uint32_t depth{0U};  //!< nesting level of public conversion calls
+    std::uint32_t budget{0U};  //!< the budget captured at the outermost call
+    std::uint32_t steps{0U};  //!< the steps used so far
+    bool exhausted{false};  //!< the budget was exceeded
+    bool instrumented{false};  //!< statistics are collected for the call
+    bool timed{false};  //!< the call is sampled for the latency histogram
+    parse_phase phase{parse_phase::direct_lookup};  //!< the latest phase
+    std::uint32_t unitDepth{0U};  //!< unit_from_string_internal nesting
+    std::uint32_t maxUnitDepth{0U};  //!< deepest unit_from_string_internal
+    std::uint32_t copies{0U};  //!< segments copied for recursion
+    std::uint32_t sampleCount{0U};  //!< conversions since the last sample
+    std::chrono::steady_clock::time_point start;  //!< start of a timed call
+};
+
+static thread_local parse_work parseWork;
+
+static std::atomic<bool> parseInstrumentation{false};
+static std::atomic<std::uint32_t> parseLatencySampleInterval{0U};
+
+/// the accumulated parse statistics
+struct parse_counters {
+    std::atomic<std::uint64_t> conversions;
+    std::atomic<std::uint64_t> failures;
+    std::array<std::atomic<std::uint64_t>, parse_phase_count> resolutions;
+    std::atomic<std::uint64_t> stringCopies;
+    std::atomic<std::uint64_t> totalDepth;
+    std::atomic<std::uint32_t> maxDepth;
+    std::array<std::atomic<std::uint64_t>, 32> latency;
+    std::atomic<std::uint64_t> latencySamples;
+};
+
+// static storage so all the counters start at 0
+static parse_counters parseCounters;
+
+void enableParseInstrumentation(std::uint32_t latencySampleInterval)
+{
+    parseLatencySampleInterval.store(latencySampleInterval);
+    parseInstrumentation.store(true);
+}
+
+void disableParseInstrumentation()
+{
+    parseInstrumentation.store(false);
+}
+
+void resetParseStatistics()
+{
+    parseCounters.conversions.store(0U);
+    parseCounters.failures.store(0U);
+    for (auto& counter : parseCounters.resolutions) {
+        counter.store(0U);
+    }
+    parseCounters.stringCopies.store(0U);
+    parseCounters.totalDepth.store(0U);
+    parseCounters.maxDepth.store(0U);
+    for (auto& counter : parseCounters.latency) {
+        counter.store(0U);
+    }
+    parseCounters.latencySamples.store(0U);
+}
+
+parse_statistics getParseStatistics()
+{
+    parse_statistics stats;
+    stats.conversions = parseCounters.conversions.load();
+    stats.failures = parseCounters.failures.load();
+    for (std::size_t ii = 0; ii < parse_phase_count; ++ii) {
+        stats.resolutions[ii] = parseCounters.resolutions[ii].load();
+    }
+    stats.string_copies = parseCounters.stringCopies.load();
+    stats.total_recursion_depth = parseCounters.totalDepth.load();
+    stats.max_recursion_depth = parseCounters.maxDepth.load();
+    for (std::size_t ii = 0; ii < stats.latency_histogram.size(); ++ii) {
+        stats.latency_histogram[ii] = parseCounters.latency[ii].load();
+    }
+    stats.latency_samples = parseCounters.latencySamples.load();
+    return stats;
+}
+
+std::uint32_t setParseStepBudget(std::uint32_t maxSteps)
+{
+    auto previous = parseStepBudget.exchange(maxSteps);
+    if (previous != maxSteps) {
+        // stored results may depend on the old budget
+        clearParseCache();
+    }
+    return previous;
+}
+
+std::uint32_t getParseStepBudget()
+{
+    return parseStepBudget.load();
+}
+
+std::uint64_t getParseBudgetExhaustedCount()
+{
+    return parseBudgetExhausted.load();
+}
+
+/** track the budget for a public string conversion call, only the outermost
+call on a thread sets the budget and resets the step count*/
+class ParseWorkScope {
+  public:
+    explicit ParseWorkScope(std::uint32_t stepBudget = default_step_budget) :
+        outermost(parseWork.depth++ == 0U)
+    {
+        if (outermost) {
+            parseWork.budget = (stepBudget == default_step_budget) ?
+                parseStepBudget.load(std::memory_order_relaxed) :
+                stepBudget;
+            parseWork.steps = 0U;
+            parseWork.exhausted = false;
+            parseWork.instrumented =
+                parseInstrumentation.load(std::memory_order_relaxed);
+            if (parseWork.instrumented) {
+                startInstrumentation();
+            }
+        }
+    }
+    ~ParseWorkScope()
+    {
+        --parseWork.depth;
+        if (outermost && parseWork.exhausted) {
+            parseBudgetExhausted.fetch_add(1U, std::memory_order_relaxed);
+        }
+    }
+    ParseWorkScope(const ParseWorkScope&) = delete;
+    ParseWorkScope& operator=(const ParseWorkScope&) = delete;
+    /// check if the conversion ran out of steps
+    bool exhausted() const { return parseWork.exhausted; }
+    /// record the outcome of the conversion in the parse statistics
+    void finish(bool valid) const
+    {
+        if (outermost && parseWork.instrumented) {
+            recordInstrumentation(valid);
+        }
+    }
+
+  private:
+    static void startInstrumentation()
+    {
+        parseWork.phase = parse_phase::direct_lookup;
+        parseWork.maxUnitDepth = 0U;
+        parseWork.copies = 0U;
+        auto interval =
+            parseLatencySampleInterval.load(std::memory_order_relaxed);
+        parseWork.timed = false;
+        if (interval > 0U && ++parseWork.sampleCount >= interval) {
+            parseWork.sampleCount = 0U;
+            parseWork.timed = true;
+            parseWork.start = std::chrono::steady_clock::now();
+        }
+    }
+    static void recordInstrumentation(bool valid)
+    {
+        constexpr auto relaxed = std::memory_order_relaxed;
+        if (parseWork.timed) {
+            auto nanoseconds =
+                std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - parseWork.start)
+                    .count();
+            std::size_t bucket{0};
+            while (nanoseconds > 1 && bucket < 31) {
+                nanoseconds >>= 1;
+                ++bucket;
+            }
+            parseCounters.latency[bucket].fetch_add(1U, relaxed);
+            parseCounters.latencySamples.fetch_add(1U, relaxed);
+        }
+        parseCounters.conversions.fetch_add(1U, relaxed);
+        if (valid) {
+            parseCounters.resolutions[static_cast<std::size_t>(parseWork.phase)]
+                .fetch_add(1U, relaxed);
+        } else {
+            parseCounters.failures.fetch_add(1U, relaxed);
+        }
+        parseCounters.stringCopies.fetch_add(parseWork.copies, relaxed);
+        parseCounters.totalDepth.fetch_add(parseWork.maxUnitDepth, relaxed);
+        auto depth = parseCounters.maxDepth.load(relaxed);
+        while (depth < parseWork.maxUnitDepth &&
+               !parseCounters.maxDepth.compare_exchange_weak(
+                   depth, parseWork.maxUnitDepth, relaxed)) {
+        }
+    }
+    bool outermost;
+};
+
+/// track the nesting of unit_from_string_internal for the parse statistics
+class UnitDepthScope {
+  public:
+    UnitDepthScope()
+    {
+        if (parseWork.instrumented) {
+            if (++parseWork.unitDepth > 1U) {
+                // every nested call interprets its own copy of a segment
+                ++parseWork.copies;
+            }
+            if (parseWork.unitDepth > parseWork.maxUnitDepth) {
+                parseWork.maxUnitDepth = parseWork.unitDepth;
+            }
+        }
+    }
+    ~UnitDepthScope()
+    {
+        if (parseWork.instrumented) {
+            --parseWork.unitDepth;
+        }
+    }
+    UnitDepthScope(const UnitDepthScope&) = delete;
+    UnitDepthScope& operator=(const UnitDepthScope&) = delete;
+};
+
+/// note the phase of the outermost unit interpretation for the statistics
+static void noteParsePhase(parse_phase phase)
+{
+    if (parseWork.instrumented && parseWork.unitDepth == 1U) {
+        parseWork.phase = phase;
+    }
+}
+
+/// use a step from the budget, returns false if no steps remain
+static bool takeParseStep()
+{
+    if (parseWork.budget == 0U) {
+        return true;
+    }
+    if (parseWork.exhausted || ++parseWork.steps > parseWork.budget) {
+        parseWork.exhausted = true;
+        return false;
+    }
+    return true;
+}
+
 static std::atomic<bool> allowUserDefinedUnits{true};
 
 void disableUserDefinedUnits()
 {
     allowUserDefinedUnits.store(false);
+    clearStringCaches();
 }
 void enableUserDefinedUnits()
 {
     allowUserDefinedUnits.store(true);
+    clearStringCaches();
 }
 
 static constexpr int getDefaultDomain()
@@ -658,7 +1496,10 @@ static int unitsDomain{getDefaultDomain()};
 
 int setUnitsDomain(int newDomain)
 {
-    unitsDomain = newDomain;
+    if (newDomain != unitsDomain) {
+        unitsDomain = newDomain;
+        clearStringCaches();
+    }
     return unitsDomain;
 }
 
@@ -668,27 +1509,133 @@ using smap = std::unordered_map<std::string, precise_unit>;
 static double
     getDoubleFromString(const std::string& ustring, size_t* index) noexcept;
 
-static std::unordered_map<unit, std::string> user_defined_unit_names;
-static smap user_defined_units;
+/// an immutable version of the user defined units
+struct user_defined_snapshot {
+    /// the names of user defined units for generating strings
+    std::unordered_map<unit, std::string> names;
+    /// the user defined units for interpreting strings
+    smap units;
+};
+
+/// serializes the modifications of the user defined units, held by writers
+/// while a new snapshot is built
+static std::mutex& userDefinedWriteLock()
+{
+    static std::mutex writeLock;
+    return writeLock;
+}
+
+/// guards the current snapshot pointer, held only to copy or replace it
+static std::mutex& userDefinedPublishLock()
+{
+    static std::mutex publishLock;
+    return publishLock;
+}
+
+/** the current user defined units, replaced with both locks held so writers
+may read it with only the write lock and readers with only the publish lock*/
+static std::shared_ptr<const user_defined_snapshot>& userDefinedCurrent()
+{
+    static std::shared_ptr<const user_defined_snapshot> current;
+    return current;
+}
+
+/// incremented with the publish lock held each time a snapshot is published
+static std::atomic<std::uint64_t> userDefinedVersion{0U};
+
+/// the user defined units snapshot in use on a thread
+struct user_defined_cache {
+    std::shared_ptr<const user_defined_snapshot> snapshot;
+    std::uint64_t version{0U};  //!< the version of the snapshot
+    std::uint32_t depth{0U};  //!< nesting of UserDefinedScope objects
+};
+
+static thread_local user_defined_cache userDefinedCache;
+
+/** access to the user defined units for reading
+@details the thread keeps a reference to the snapshot it last used so a read
+only checks the version counter.  The publish lock is taken only to pick up
+a newly published snapshot, and only by the outermost scope on the thread so
+a snapshot is never released while a nested lookup is using it*/
+class UserDefinedScope {
+  public:
+    UserDefinedScope()
+    {
+        if (userDefinedCache.depth++ == 0U &&
+            userDefinedVersion.load(std::memory_order_acquire) !=
+                userDefinedCache.version) {
+            std::lock_guard<std::mutex> lock(userDefinedPublishLock());
+            userDefinedCache.snapshot = userDefinedCurrent();
+            userDefinedCache.version =
+                userDefinedVersion.load(std::memory_order_relaxed);
+        }
+    }
+    ~UserDefinedScope() { --userDefinedCache.depth; }
+    UserDefinedScope(const UserDefinedScope&) = delete;
+    UserDefinedScope& operator=(const UserDefinedScope&) = delete;
+
+    /// the user defined units, nullptr if there are none
+    const user_defined_snapshot* get() const
+    {
+        return userDefinedCache.snapshot.get();
+    }
+    /// check if there are any user defined unit names
+    bool hasNames() const
+    {
+        return get() != nullptr && !get()->names.empty();
+    }
+    /// check if there are any user defined units
+    bool hasUnits() const { return get() != nullptr && !get()->units.empty(); }
+};
+
+/** publish a modified copy of the current user defined units, readers pick up
+the new snapshot on their next lookup and the old one is released when the
+last thread using it moves on
+@details the copy is built holding only the write lock so readers refreshing
+their snapshot wait only for the pointer swap*/
+template<typename Modifier>
+static void updateUserDefinedUnits(Modifier modify)
+{
+    {
+        std::lock_guard<std::mutex> lock(userDefinedWriteLock());
+        auto& current = userDefinedCurrent();
+        std::shared_ptr<const user_defined_snapshot> next;
+        {
+            auto modified = (current) ?
+                std::make_shared<user_defined_snapshot>(*current) :
+                std::make_shared<user_defined_snapshot>();
+            modify(*modified);
+            if (!modified->names.empty() || !modified->units.empty()) {
+                next = std::move(modified);
+            }
+        }
+        {
+            std::lock_guard<std::mutex> publish(userDefinedPublishLock());
+            current.swap(next);
+            userDefinedVersion.fetch_add(1U, std::memory_order_release);
+        }
+        // next now holds the previous snapshot, released outside the publish
+        // lock
+    }
+    clearStringCaches();
+}
 
 void addUserDefinedUnit(const std::string& name, const precise_unit& un)
 {
     if (allowUserDefinedUnits.load(std::memory_order_acquire)) {
-        user_defined_unit_names[unit_cast(un)] = name;
-        user_defined_units[name] = un;
-        allowUserDefinedUnits.store(
-            allowUserDefinedUnits.load(std::memory_order_acquire),
-            std::memory_order_release);
+        updateUserDefinedUnits([&name, &un](user_defined_snapshot& defs) {
+            defs.names[unit_cast(un)] = name;
+            defs.units[name] = un;
+        });
     }
 }
 
 void addUserDefinedInputUnit(const std::string& name, const precise_unit& un)
 {
     if (allowUserDefinedUnits.load(std::memory_order_acquire)) {
-        user_defined_units[name] = un;
-        allowUserDefinedUnits.store(
-            allowUserDefinedUnits.load(std::memory_order_acquire),
-            std::memory_order_release);
+        updateUserDefinedUnits([&name, &un](user_defined_snapshot& defs) {
+            defs.units[name] = un;
+        });
     }
 }
 
@@ -797,8 +1744,10 @@ std::string definedUnitsFromFile(const std::string& filename) noexcept
 
 void clearUserDefinedUnits()
 {
-    user_defined_unit_names.clear();
-    user_defined_units.clear();
+    updateUserDefinedUnits([](user_defined_snapshot& defs) {
+        defs.names.clear();
+        defs.units.clear();
+    });
 }
 
 // add escapes for some particular sequences
@@ -1069,81 +2018,202 @@ static std::string
     return propUnitString;
 }
 
-static const std::pair<const unit, std::string> nullret{invalid, std::string{}};
-
 static std::pair<unit, std::string> find_unit_pair(unit un)
 {
     if (allowUserDefinedUnits.load(std::memory_order_acquire)) {
-        if (!user_defined_unit_names.empty()) {
-            auto fndud = user_defined_unit_names.find(un);
-            if (fndud != user_defined_unit_names.end()) {
+        UserDefinedScope userDefined;
+        if (userDefined.hasNames()) {
+            const auto& names = userDefined.get()->names;
+            auto fndud = names.find(un);
+            if (fndud != names.end()) {
                 return {fndud->first, fndud->second};
             }
         }
     }
-    auto fnd = base_unit_names.find(un);
-    if (fnd != base_unit_names.end()) {
-        return {fnd->first, fnd->second};
-    }
-    return nullret;
-}
-
-static std::string find_unit(unit un)
-{
-    if (allowUserDefinedUnits.load(std::memory_order_acquire)) {
-        if (!user_defined_unit_names.empty()) {
-            auto fndud = user_defined_unit_names.find(un);
-            if (fndud != user_defined_unit_names.end()) {
-                return fndud->second;
+    auto fnd = findUnitName(un);
+    if (fnd != nullptr) {
+        return {fnd->first, fnd->second};
+    }
+    return {invalid, std::string{}};
+}
+
+static std::string find_unit(unit un)
+{
+    if (allowUserDefinedUnits.load(std::memory_order_acquire)) {
+        UserDefinedScope userDefined;
+        if (userDefined.hasNames()) {
+            const auto& names = userDefined.get()->names;
+            auto fndud = names.find(un);
+            if (fndud != names.end()) {
+                return fndud->second;
+            }
+        }
+    }
+    auto fnd = findUnitName(un);
+    if (fnd != nullptr) {
+        return fnd->second;
+    }
+    return std::string{};
+}
+
+/** the combinations of a unit and a probe unit tested by probeUnit and
+probeUnitBase*/
+enum probe_form : std::uint8_t {
+    probe_multiply = 1,  //!< the unit multiplied by the probe
+    probe_multiply_inverse = 2,  //!< the inverse of probe_multiply
+    probe_divide = 4,  //!< the unit divided by the probe
+    probe_divide_inverse = 8,  //!< the inverse of probe_divide
+    all_probe_forms = 15,
+};
+
+/// the number of probes covered by the ProbeIndex
+static constexpr std::size_t probeCount{
+    testUnits.size() + 2 * testPowerUnits.size()};
+
+using probe_forms = std::array<std::uint8_t, probeCount>;
+
+/** index of which probe units can produce a named unit for a given dimension
+@details a probe can only find a name if the resulting dimension matches one
+of the named units, so the forms of each probe which could succeed are
+computed once per dimension and stored.  The probes are numbered in the order
+testUnits, then the square and cube of each of the testPowerUnits*/
+class ProbeIndex {
+  public:
+    ProbeIndex()
+    {
+        for (const auto& name : defined_unit_names) {
+            if (name.second != nullptr) {
+                namedDimensions.insert(name.first.base_units());
+            }
+        }
+        probeDimensions.reserve(probeCount);
+        for (const auto& tu : testUnits) {
+            probeDimensions.push_back(tu.first.base_units());
+        }
+        for (const auto& tu : testPowerUnits) {
+            probeDimensions.push_back(tu.first.base_units().pow(2));
+            probeDimensions.push_back(tu.first.base_units().pow(3));
+        }
+        formCache.setCapacity(1024);
+    }
+    /// get the forms of each probe which could match a named unit
+    probe_forms candidates(const detail::unit_data& dimension)
+    {
+        probe_forms forms;
+        auto hash = std::hash<detail::unit_data>()(dimension);
+        if (formCache.find(
+                hash,
+                [&dimension](const unit& key) {
+                    return key.base_units() == dimension;
+                },
+                forms)) {
+            return forms;
+        }
+        for (std::size_t ii = 0; ii < probeCount; ++ii) {
+            auto product = dimension * probeDimensions[ii];
+            auto quotient = dimension / probeDimensions[ii];
+            std::uint8_t form{0};
+            if (named(product)) {
+                form |= probe_multiply;
             }
+            if (named(product.inv())) {
+                form |= probe_multiply_inverse;
+            }
+            if (named(quotient)) {
+                form |= probe_divide;
+            }
+            if (named(quotient.inv())) {
+                form |= probe_divide_inverse;
+            }
+            forms[ii] = form;
         }
+        formCache.insert(hash, unit(dimension), forms, formCache.generation());
+        return forms;
     }
-    auto fnd = base_unit_names.find(un);
-    if (fnd != base_unit_names.end()) {
-        return fnd->second;
+
+  private:
+    bool named(const detail::unit_data& dimension) const
+    {
+        return namedDimensions.find(dimension) != namedDimensions.end();
     }
-    return std::string{};
+    std::unordered_set<detail::unit_data> namedDimensions;
+    std::vector<detail::unit_data> probeDimensions;
+    ShardedCache<unit, probe_forms> formCache;
+};
+
+/// get the forms of each probe unit which could name a unit
+static probe_forms probeCandidates(const precise_unit& un)
+{
+    if (allowUserDefinedUnits.load(std::memory_order_acquire) &&
+        UserDefinedScope().hasNames()) {
+        // user defined names can have any dimension
+        probe_forms forms;
+        forms.fill(all_probe_forms);
+        return forms;
+    }
+    static ProbeIndex probeIndex;
+    return probeIndex.candidates(un.base_units());
 }
 
 static std::string probeUnit(
     const precise_unit& un,
-    const std::pair<precise_unit, const char*>& probe)
+    const std::pair<precise_unit, const char*>& probe,
+    std::uint8_t forms = all_probe_forms)
 {
+    if (forms == 0) {
+        return std::string{};
+    }
     // let's try common divisor units
     auto ext = un * probe.first;
-    auto fnd = find_unit(unit_cast(ext));
-    if (!fnd.empty()) {
-        return fnd + '/' + probe.second;
+    std::string fnd;
+    if ((forms & probe_multiply) != 0) {
+        fnd = find_unit(unit_cast(ext));
+        if (!fnd.empty()) {
+            return fnd + '/' + probe.second;
+        }
     }
     // let's try inverse of common multiplier units
-    fnd = find_unit(unit_cast(ext.inv()));
-    if (!fnd.empty()) {
-        return std::string("1/(") + fnd + '*' + probe.second + ')';
+    if ((forms & probe_multiply_inverse) != 0) {
+        fnd = find_unit(unit_cast(ext.inv()));
+        if (!fnd.empty()) {
+            return std::string("1/(") + fnd + '*' + probe.second + ')';
+        }
     }
 
     // let's try common multiplier units
     ext = un / probe.first;
-    fnd = find_unit(unit_cast(ext));
-    if (!fnd.empty()) {
-        return fnd + '*' + probe.second;
+    if ((forms & probe_divide) != 0) {
+        fnd = find_unit(unit_cast(ext));
+        if (!fnd.empty()) {
+            return fnd + '*' + probe.second;
+        }
     }
     // let's try common divisor with inv units
-    fnd = find_unit(unit_cast(ext.inv()));
-    if (!fnd.empty()) {
-        return std::string(probe.second) + '/' + fnd;
+    if ((forms & probe_divide_inverse) != 0) {
+        fnd = find_unit(unit_cast(ext.inv()));
+        if (!fnd.empty()) {
+            return std::string(probe.second) + '/' + fnd;
+        }
     }
     return std::string{};
 }
 
 static std::string probeUnitBase(
     const precise_unit& un,
-    const std::pair<precise_unit, const char*>& probe)
+    const std::pair<precise_unit, const char*>& probe,
+    std::uint8_t forms = all_probe_forms)
 {
     std::string beststr;
+    if (forms == 0) {
+        return beststr;
+    }
     // let's try common divisor units on base units
     auto ext = un * probe.first;
     auto base = unit(ext.base_units());
-    auto fnd = find_unit(base);
+    std::string fnd;
+    if ((forms & probe_multiply) != 0) {
+        fnd = find_unit(base);
+    }
     if (!fnd.empty()) {
         auto prefix = generateUnitSequence(ext.multiplier(), fnd);
 
@@ -1156,7 +2226,8 @@ static std::string probeUnitBase(
         }
     }
     // let's try inverse of common multiplier units on base units
-    fnd = find_unit(base.inv());
+    fnd = ((forms & probe_multiply_inverse) != 0) ? find_unit(base.inv()) :
+                                                    std::string{};
     if (!fnd.empty()) {
         auto prefix = getMultiplierString(
             1.0 / ext.multiplier(), isDigitCharacter(fnd.back()));
@@ -1176,7 +2247,7 @@ static std::string probeUnitBase(
     // let's try common multiplier units on base units
     ext = un / probe.first;
     base = unit(ext.base_units());
-    fnd = find_unit(base);
+    fnd = ((forms & probe_divide) != 0) ? find_unit(base) : std::string{};
     if (!fnd.empty()) {
         auto prefix = generateUnitSequence(ext.multiplier(), fnd);
         auto str = prefix + '*' + probe.second;
@@ -1188,7 +2259,8 @@ static std::string probeUnitBase(
         }
     }
     // let's try common divisor with inv units on base units
-    fnd = find_unit(base.inv());
+    fnd = ((forms & probe_divide_inverse) != 0) ? find_unit(base.inv()) :
+                                                  std::string{};
     if (!fnd.empty()) {
         auto prefix = generateUnitSequence(1.0 / ext.multiplier(), fnd);
         if (isNumericalStartCharacter(prefix.front())) {
@@ -1505,15 +2577,19 @@ static std::string
     }
 
     // let's try common units
+    auto forms = probeCandidates(un);
+    std::size_t probeIndex{0};
     for (const auto& tu : testUnits) {
-        auto res = probeUnit(un, tu);
+        auto res = probeUnit(un, tu, forms[probeIndex++]);
         if (!res.empty()) {
             return res;
         }
     }
 
-    if (allowUserDefinedUnits.load(std::memory_order_acquire)) {
-        for (const auto& udu : user_defined_unit_names) {
+    UserDefinedScope userDefined;
+    if (allowUserDefinedUnits.load(std::memory_order_acquire) &&
+        userDefined.hasNames()) {
+        for (const auto& udu : userDefined.get()->names) {
             auto res = probeUnit(
                 un,
                 std::make_pair(precise_unit(udu.first), udu.second.c_str()));
@@ -1541,23 +2617,33 @@ static std::string
 
     // let's try common units that are often multiplied by power
     for (const auto& tu : testPowerUnits) {
+        auto squareForms = forms[probeIndex++];
+        auto cubeForms = forms[probeIndex++];
+        if ((squareForms | cubeForms) == 0) {
+            continue;
+        }
         std::string nstring = std::string(tu.second) + "^2";
         auto res = probeUnit(
-            un, std::make_pair(precise_unit(tu.first).pow(2), nstring.c_str()));
+            un,
+            std::make_pair(precise_unit(tu.first).pow(2), nstring.c_str()),
+            squareForms);
         if (!res.empty()) {
             return res;
         }
         nstring = std::string(tu.second) + "^3";
         res = probeUnit(
-            un, std::make_pair(precise_unit(tu.first).pow(3), nstring.c_str()));
+            un,
+            std::make_pair(precise_unit(tu.first).pow(3), nstring.c_str()),
+            cubeForms);
         if (!res.empty()) {
             return res;
         }
     }
     std::string beststr;
 
+    probeIndex = 0;
     for (auto& tu : testUnits) {
-        auto str = probeUnitBase(un, tu);
+        auto str = probeUnitBase(un, tu, forms[probeIndex++]);
         if (!str.empty()) {
             if (!isNumericalStartCharacter(str.front())) {
                 return str;
@@ -1567,8 +2653,9 @@ static std::string
             }
         }
     }
-    if (allowUserDefinedUnits.load(std::memory_order_acquire)) {
-        for (const auto& udu : user_defined_unit_names) {
+    if (allowUserDefinedUnits.load(std::memory_order_acquire) &&
+        userDefined.hasNames()) {
+        for (const auto& udu : userDefined.get()->names) {
             auto str = probeUnitBase(
                 un,
                 std::make_pair(precise_unit(udu.first), udu.second.c_str()));
@@ -1610,9 +2697,16 @@ static std::string
         }
     }
     for (auto& tu : testPowerUnits) {
+        auto squareForms = forms[probeIndex++];
+        auto cubeForms = forms[probeIndex++];
+        if ((squareForms | cubeForms) == 0) {
+            continue;
+        }
         std::string nstring = std::string(tu.second) + "^2";
         auto str = probeUnitBase(
-            un, std::make_pair(precise_unit(tu.first).pow(2), nstring.c_str()));
+            un,
+            std::make_pair(precise_unit(tu.first).pow(2), nstring.c_str()),
+            squareForms);
         if (!str.empty()) {
             if (!isNumericalStartCharacter(str.front())) {
                 return str;
@@ -1624,7 +2718,9 @@ static std::string
 
         nstring = std::string(tu.second) + "^3";
         str = probeUnitBase(
-            un, std::make_pair(precise_unit(tu.first).pow(3), nstring.c_str()));
+            un,
+            std::make_pair(precise_unit(tu.first).pow(3), nstring.c_str()),
+            cubeForms);
         if (!str.empty()) {
             if (!isNumericalStartCharacter(str.front())) {
                 return str;
@@ -1659,8 +2755,252 @@ static std::string
 
 std::string to_string(const precise_unit& un, std::uint32_t match_flags)
 {
-    return clean_unit_string(
-        to_string_internal(un, match_flags), un.commodity());
+    if (!unitStringCache().enabled()) {
+        return clean_unit_string(
+            to_string_internal(un, match_flags), un.commodity());
+    }
+    auto hash = unitStringHash(un, match_flags);
+    std::string result;
+    if (unitStringCache().find(
+            hash,
+            [&un, match_flags](const unit_string_key& key) {
+                return key.second == match_flags &&
+                    identicalUnits(key.first, un);
+            },
+            result)) {
+        return result;
+    }
+    auto generation = unitStringCache().generation();
+    result =
+        clean_unit_string(to_string_internal(un, match_flags), un.commodity());
+    unitStringCache().insert(
+        hash, unit_string_key(un, match_flags), result, generation);
+    return result;
+}
+
+// copy a unit string into a character buffer, optionally in parenthesis
+static to_chars_result writeUnitChars(
+    char* first,
+    char* last,
+    const std::string& str,
+    bool parenthesize)
+{
+    parenthesize = parenthesize && !str.empty() &&
+        isNumericalStartCharacter(str.front());
+    auto length = str.size() + (parenthesize ? 2U : 0U);
+    if (static_cast<std::size_t>(last - first) < length) {
+        return {last, std::errc::value_too_large};
+    }
+    if (parenthesize) {
+        *first++ = '(';
+    }
+    std::copy(str.begin(), str.end(), first);
+    first += str.size();
+    if (parenthesize) {
+        *first++ = ')';
+    }
+    return {first, std::errc()};
+}
+
+// write a unit string into a buffer using the to_string cache when possible
+static to_chars_result unitToChars(
+    char* first,
+    char* last,
+    const precise_unit& un,
+    std::uint32_t match_flags,
+    bool parenthesize)
+{
+    if (unitStringCache().enabled()) {
+        to_chars_result result{last, std::errc::value_too_large};
+        if (unitStringCache().visit(
+                unitStringHash(un, match_flags),
+                [&un, match_flags](const unit_string_key& key) {
+                    return key.second == match_flags &&
+                        identicalUnits(key.first, un);
+                },
+                [&](const std::string& str) {
+                    result = writeUnitChars(first, last, str, parenthesize);
+                })) {
+            return result;
+        }
+    }
+    return writeUnitChars(
+        first, last, to_string(un, match_flags), parenthesize);
+}
+
+to_chars_result to_chars(
+    char* first,
+    char* last,
+    const precise_unit& un,
+    std::uint32_t match_flags)
+{
+    return unitToChars(first, last, un, match_flags, false);
+}
+
+to_chars_result to_chars(
+    char* first,
+    char* last,
+    const precise_measurement& measure,
+    std::uint32_t match_flags)
+{
+    char buffer[numberBufferSize];
+    auto length = formatNumber(measure.value(), buffer);
+    if (static_cast<std::size_t>(last - first) < length + 1) {
+        return {last, std::errc::value_too_large};
+    }
+    first = std::copy(buffer, buffer + length, first);
+    *first++ = ' ';
+    return unitToChars(first, last, measure.units(), match_flags, true);
+}
+
+// append a unit string quoted and escaped as a CSV field
+static void
+    appendCsvField(std::string& out, const std::string& str, char delim)
+{
+    if (str.find_first_of("\"\r\n") == std::string::npos &&
+        str.find(delim) == std::string::npos) {
+        out.append(str);
+        return;
+    }
+    out.push_back('"');
+    for (auto c : str) {
+        if (c == '"') {
+            out.push_back('"');
+        }
+        out.push_back(c);
+    }
+    out.push_back('"');
+}
+
+// append a unit string as a JSON string
+static void appendJsonString(std::string& out, const std::string& str)
+{
+    static constexpr const char* hexDigits{"0123456789abcdef"};
+    out.push_back('"');
+    for (auto c : str) {
+        auto uc = static_cast<unsigned char>(c);
+        if (c == '"' || c == '\\') {
+            out.push_back('\\');
+            out.push_back(c);
+        } else if (uc < 0x20U) {
+            out.append("\\u00");
+            out.push_back(hexDigits[uc >> 4U]);
+            out.push_back(hexDigits[uc & 0x0FU]);
+        } else {
+            out.push_back(c);
+        }
+    }
+    out.push_back('"');
+}
+
+/** generates the text following the value in each record for the distinct
+units of a batch of measurements*/
+class RecordSuffixes {
+  public:
+    RecordSuffixes(
+        record_format format,
+        char delimiter,
+        std::uint32_t match_flags) :
+        format_(format),
+        delimiter_(delimiter), flags_(match_flags)
+    {
+    }
+    /// get the suffix for a unit, units are converted to strings only once
+    const std::string& suffix(const precise_unit& un)
+    {
+        if (last_ != nullptr && identicalUnits(last_->first, un)) {
+            return last_->second;
+        }
+        auto range = index_.equal_range(unitStringHash(un, 0U));
+        for (auto it = range.first; it != range.second; ++it) {
+            if (identicalUnits(it->second.first, un)) {
+                last_ = &it->second;
+                return last_->second;
+            }
+        }
+        std::string text;
+        auto ustring = to_string(un, flags_);
+        if (format_ == record_format::ndjson) {
+            text.append(",\"unit\":");
+            appendJsonString(text, ustring);
+            text.append("}\n");
+        } else {
+            text.push_back(delimiter_);
+            appendCsvField(text, ustring, delimiter_);
+            text.push_back('\n');
+        }
+        auto it = index_.emplace(
+            unitStringHash(un, 0U), std::make_pair(un, std::move(text)));
+        last_ = &it->second;
+        return last_->second;
+    }
+
+  private:
+    record_format format_;
+    char delimiter_;
+    std::uint32_t flags_;
+    std::unordered_multimap<
+        std::uint64_t,
+        std::pair<precise_unit, std::string>>
+        index_;
+    const std::pair<precise_unit, std::string>* last_{nullptr};
+};
+
+// append a single measurement record
+static void appendRecord(
+    std::string& output,
+    double value,
+    const std::string& suffix,
+    record_format format)
+{
+    char buffer[numberBufferSize];
+    if (format == record_format::ndjson) {
+        output.append("{\"value\":");
+        if (!std::isfinite(value)) {
+            // JSON has no representation of inf or nan
+            output.append("null");
+            output.append(suffix);
+            return;
+        }
+    }
+    output.append(buffer, formatNumber(value, buffer));
+    output.append(suffix);
+}
+
+void measurements_to_string(
+    const precise_measurement* measurements,
+    std::size_t measurement_count,
+    std::string& output,
+    record_format format,
+    char delimiter,
+    std::uint32_t match_flags)
+{
+    RecordSuffixes suffixes(format, delimiter, match_flags);
+    output.reserve(output.size() + measurement_count * 32U);
+    for (std::size_t ii = 0; ii < measurement_count; ++ii) {
+        appendRecord(
+            output,
+            measurements[ii].value(),
+            suffixes.suffix(measurements[ii].units()),
+            format);
+    }
+}
+
+void measurements_to_string(
+    const double* values,
+    std::size_t value_count,
+    const precise_unit& units,
+    std::string& output,
+    record_format format,
+    char delimiter,
+    std::uint32_t match_flags)
+{
+    RecordSuffixes suffixes(format, delimiter, match_flags);
+    const auto& suffix = suffixes.suffix(units);
+    output.reserve(output.size() + value_count * (24U + suffix.size()));
+    for (std::size_t ii = 0; ii < value_count; ++ii) {
+        appendRecord(output, values[ii], suffix, format);
+    }
 }
 
 std::string
@@ -1870,11 +3210,20 @@ static double getPrefixMultiplier2Char(char c1, char c2)
 // do a segment check in the forward direction
 static bool
     segmentcheck(const std::string& unit, char closeSegment, size_t& index);
+static bool segmentcheck(
+    const char* unit,
+    std::size_t length,
+    char closeSegment,
+    size_t& index);
 
 /** generate a number representing the leading portion of a string
 the index of the first non-converted character is returned in index*/
 static double
     generateLeadingNumber(const std::string& ustring, size_t& index) noexcept;
+static double generateLeadingNumber(
+    const char* str,
+    std::size_t length,
+    size_t& index) noexcept;
 
 /** generate a number representing the leading portion of a string if the words
 are numerical in nature the index of the first non-converted character is
@@ -1883,58 +3232,538 @@ static double readNumericalWords(const std::string& ustring, size_t& index);
 
 // Detect if a string looks like a number
 static bool looksLikeNumber(const std::string& string, size_t index = 0);
+static bool
+    looksLikeNumber(const char* string, std::size_t length, size_t index);
 
-/** a function very similar to stod that uses the lower level strtod and does
- * things a little smarter for our case
- */
+/// whitespace characters as classified by isspace in the "C" locale
+static inline bool isCSpaceCharacter(char X)
+{
+    return (X == ' ' || (X >= '\t' && X <= '\r'));
+}
+
+static inline int hexDigitValue(char X)
+{
+    if (X >= '0' && X <= '9') {
+        return X - '0';
+    }
+    if (X >= 'a' && X <= 'f') {
+        return X - 'a' + 10;
+    }
+    if (X >= 'A' && X <= 'F') {
+        return X - 'A' + 10;
+    }
+    return -1;
+}
+
+/// case insensitive check for an ascii lower case word at a location
+static bool matchesWord(
+    const char* str,
+    std::size_t length,
+    std::size_t pos,
+    const char* word)
+{
+    for (; *word != '\0'; ++word, ++pos) {
+        if (pos >= length || (str[pos] | 0x20) != *word) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/** read an exponent of the form [+-]digits starting at pos, pos is only
+advanced if digits are present*/
+static void readExponent(
+    const char* str,
+    std::size_t length,
+    std::size_t& pos,
+    int& exponent)
+{
+    auto epos = pos;
+    bool negative{false};
+    if (epos < length && (str[epos] == '-' || str[epos] == '+')) {
+        negative = (str[epos] == '-');
+        ++epos;
+    }
+    if (epos >= length || !isDigitCharacter(str[epos])) {
+        return;
+    }
+    int value{0};
+    for (; epos < length && isDigitCharacter(str[epos]); ++epos) {
+        // anything this large is an overflow or underflow anyway
+        if (value < 100000) {
+            value = value * 10 + (str[epos] - '0');
+        }
+    }
+    exponent += negative ? -value : value;
+    pos = epos;
+}
+
+/** parse the digits of a hexadecimal floating point number after the 0x*/
 static double
-    getDoubleFromString(const std::string& ustring, size_t* index) noexcept
+    readHexValue(const char* str, std::size_t length, std::size_t& pos)
 {
-    char* retloc = nullptr;
-    auto vld = strtold(ustring.c_str(), &retloc);
-    // LCOV_EXCL_START
-    if (retloc == nullptr) {
-        // to the best of my knowledge this should not happen but this is a
-        // weird function sometimes with a lot of platform variations
-        *index = 0;
+    std::uint64_t mantissa{0};
+    int exponent{0};
+    bool sticky{false};
+    bool sawDigit{false};
+    bool sawDot{false};
+    for (; pos < length; ++pos) {
+        if (str[pos] == '.' && !sawDot) {
+            sawDot = true;
+            continue;
+        }
+        auto digit = hexDigitValue(str[pos]);
+        if (digit < 0) {
+            break;
+        }
+        sawDigit = true;
+        if (mantissa < (std::uint64_t{1} << 60U)) {
+            mantissa = (mantissa << 4U) + static_cast<std::uint64_t>(digit);
+            if (sawDot) {
+                exponent -= 4;
+            }
+        } else {
+            sticky = sticky || digit != 0;
+            if (!sawDot) {
+                exponent += 4;
+            }
+        }
+    }
+    if (!sawDigit) {
+        pos = 0;
+        return 0.0;
+    }
+    if (pos < length && (str[pos] == 'p' || str[pos] == 'P')) {
+        ++pos;
+        auto ppos = pos;
+        readExponent(str, length, pos, exponent);
+        if (pos == ppos) {
+            // no exponent digits so the 'p' is not part of the number
+            --pos;
+        }
+    }
+    if (sticky) {
+        // there are more than 53 significant bits so this acts as a sticky
+        // bit for the rounding in the conversion
+        mantissa |= 1U;
+    }
+    return std::ldexp(static_cast<double>(mantissa), exponent);
+}
+
+#ifndef UNITS_HAS_FLOAT_FROM_CHARS
+/** decimal digit representation used for exactly rounded conversions of
+numbers the fast path cannot handle, the value is 0.d[0]d[1]...*10^dp */
+struct decimal_digits {
+    std::array<std::uint8_t, 800> d;
+    int nd{0};
+    int dp{0};
+    bool truncated{false};
+
+    void trim()
+    {
+        while (nd > 0 && d[nd - 1] == 0) {
+            --nd;
+        }
+        if (nd == 0) {
+            dp = 0;
+        }
+    }
+    /// multiply by 2^shift
+    void leftShift(unsigned int shift)
+    {
+        // the new digits are generated from the least significant end
+        std::array<std::uint8_t, 16> extra{};
+        int extraCount{0};
+        std::uint64_t carry{0};
+        for (int ii = nd - 1; ii >= 0; --ii) {
+            auto value = (static_cast<std::uint64_t>(d[ii]) << shift) + carry;
+            d[ii] = static_cast<std::uint8_t>(value % 10U);
+            carry = value / 10U;
+        }
+        while (carry > 0) {
+            extra[extraCount++] = static_cast<std::uint8_t>(carry % 10U);
+            carry /= 10U;
+        }
+        if (extraCount > 0) {
+            auto keep = std::min(nd, static_cast<int>(d.size()) - extraCount);
+            for (int ii = keep; ii < nd; ++ii) {
+                truncated = truncated || d[ii] != 0;
+            }
+            std::copy_backward(
+                d.begin(), d.begin() + keep, d.begin() + keep + extraCount);
+            for (int ii = 0; ii < extraCount; ++ii) {
+                d[ii] = extra[extraCount - 1 - ii];
+            }
+            nd = keep + extraCount;
+            dp += extraCount;
+        }
+        trim();
+    }
+    /// divide by 2^shift
+    void rightShift(unsigned int shift)
+    {
+        int read{0};
+        int write{0};
+        std::uint64_t n{0};
+        for (; (n >> shift) == 0; ++read) {
+            if (read >= nd) {
+                if (n == 0) {
+                    nd = 0;
+                    return;
+                }
+                while ((n >> shift) == 0) {
+                    n *= 10U;
+                    ++read;
+                }
+                break;
+            }
+            n = n * 10U + d[read];
+        }
+        dp -= read - 1;
+        const std::uint64_t mask = (std::uint64_t{1} << shift) - 1U;
+        for (; read < nd; ++read) {
+            auto digit = n >> shift;
+            n &= mask;
+            d[write++] = static_cast<std::uint8_t>(digit);
+            n = n * 10U + d[read];
+        }
+        while (n > 0) {
+            auto digit = n >> shift;
+            n &= mask;
+            if (write < static_cast<int>(d.size())) {
+                d[write++] = static_cast<std::uint8_t>(digit);
+            } else if (digit > 0) {
+                truncated = true;
+            }
+            n *= 10U;
+        }
+        nd = write;
+        trim();
+    }
+    void shift(int amount)
+    {
+        // 27 keeps d*2^shift well inside 64 bits
+        while (amount > 27) {
+            leftShift(27);
+            amount -= 27;
+        }
+        while (amount < -27) {
+            rightShift(27);
+            amount += 27;
+        }
+        if (amount > 0) {
+            leftShift(static_cast<unsigned int>(amount));
+        } else if (amount < 0) {
+            rightShift(static_cast<unsigned int>(-amount));
+        }
+    }
+    /// get the integer portion rounded to nearest even
+    std::uint64_t roundedInteger() const
+    {
+        std::uint64_t n{0};
+        int ii{0};
+        for (; ii < dp && ii < nd; ++ii) {
+            n = n * 10U + d[ii];
+        }
+        for (; ii < dp; ++ii) {
+            n *= 10U;
+        }
+        if (dp >= 0 && dp < nd) {
+            bool roundUp = (d[dp] > 5);
+            if (d[dp] == 5) {
+                // exactly half way goes to the even value
+                roundUp = (dp + 1 < nd) || truncated ||
+                    (dp > 0 && (d[dp - 1] % 2U) == 1U);
+            }
+            if (roundUp) {
+                ++n;
+            }
+        }
+        return n;
+    }
+    /// generate the nearest double
+    double toDouble()
+    {
+        static constexpr int bias{-1023};
+        static constexpr unsigned int mantissaBits{52};
+        if (nd == 0 || dp < -330) {
+            return 0.0;
+        }
+        if (dp > 310) {
+            return constants::infinity;
+        }
+        // powers of two needed to scale a given power of 10 below 1
+        static UNITS_CPP14_CONSTEXPR_OBJECT std::array<int, 9> powtab{
+            {1, 3, 6, 9, 13, 16, 19, 23, 26}};
+        int exp{0};
+        while (dp > 0) {
+            auto n = (dp >= static_cast<int>(powtab.size())) ? 27 : powtab[dp];
+            shift(-n);
+            exp += n;
+        }
+        while (dp < 0 || (dp == 0 && d[0] < 5)) {
+            auto n =
+                (-dp >= static_cast<int>(powtab.size())) ? 27 : powtab[-dp];
+            shift(n);
+            exp -= n;
+        }
+        // the range is now [0.5,1) and doubles are in [1,2)
+        --exp;
+        if (exp < bias + 1) {
+            shift(-(bias + 1 - exp));
+            exp = bias + 1;
+        }
+        if (exp - bias >= 0x7FF) {
+            return constants::infinity;
+        }
+        shift(static_cast<int>(1 + mantissaBits));
+        auto mantissa = roundedInteger();
+        if (mantissa == (std::uint64_t{2} << mantissaBits)) {
+            mantissa >>= 1U;
+            ++exp;
+            if (exp - bias >= 0x7FF) {
+                return constants::infinity;
+            }
+        }
+        if ((mantissa & (std::uint64_t{1} << mantissaBits)) == 0) {
+            // denormalized
+            exp = bias;
+        }
+        const auto fractionMask = (std::uint64_t{1} << mantissaBits) - 1U;
+        auto bits = mantissa & fractionMask;
+        bits |= static_cast<std::uint64_t>((exp - bias) & 0x7FF)
+            << mantissaBits;
+        double result;
+        std::memcpy(&result, &bits, sizeof(double));
+        return result;
+    }
+};
+
+/** exactly rounded conversion of a validated decimal number of the form
+digits[.digits][e[+-]digits]*/
+static double slowDecimalConversion(const char* str, std::size_t length)
+{
+    decimal_digits dec;
+    bool sawDot{false};
+    std::size_t pos{0};
+    for (; pos < length; ++pos) {
+        auto c = str[pos];
+        if (c == '.') {
+            sawDot = true;
+            dec.dp = dec.nd;
+            continue;
+        }
+        if (!isDigitCharacter(c)) {
+            break;
+        }
+        if (c == '0' && dec.nd == 0) {
+            // leading zeros
+            --dec.dp;
+            continue;
+        }
+        if (dec.nd < static_cast<int>(dec.d.size())) {
+            dec.d[dec.nd++] = static_cast<std::uint8_t>(c - '0');
+        } else if (c != '0') {
+            dec.truncated = true;
+        }
+    }
+    if (!sawDot) {
+        dec.dp = dec.nd;
+    }
+    if (pos < length) {
+        // must be an exponent
+        ++pos;
+        readExponent(str, length, pos, dec.dp);
+    }
+    dec.trim();
+    return dec.toDouble();
+}
+#endif
+
+/** parse a floating point number from a character buffer following the
+grammar of strtod in the "C" locale but without any dependence on the current
+locale and without allocation, the number of characters used is returned in
+index which is 0 if no conversion was possible*/
+static double parseDouble(
+    const char* str,
+    std::size_t length,
+    std::size_t& index) noexcept
+{
+    static UNITS_CPP14_CONSTEXPR_OBJECT std::array<double, 23> exactPowers{
+        {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+         1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+         1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22}};
+    index = 0;
+    std::size_t pos{0};
+    while (pos < length && isCSpaceCharacter(str[pos])) {
+        ++pos;
+    }
+    bool negative{false};
+    if (pos < length && (str[pos] == '-' || str[pos] == '+')) {
+        negative = (str[pos] == '-');
+        ++pos;
+    }
+    if (pos >= length) {
         return constants::invalid_conversion;
     }
-    // LCOV_EXCL_STOP
-    *index = (retloc - ustring.c_str());
+    double value{0.0};
+    if (str[pos] == 'i' || str[pos] == 'I') {
+        if (!matchesWord(str, length, pos, "inf")) {
+            return constants::invalid_conversion;
+        }
+        pos += matchesWord(str, length, pos, "infinity") ? 8 : 3;
+        index = pos;
+        return negative ? -constants::infinity : constants::infinity;
+    }
+    if (str[pos] == 'n' || str[pos] == 'N') {
+        if (!matchesWord(str, length, pos, "nan")) {
+            return constants::invalid_conversion;
+        }
+        pos += 3;
+        if (pos < length && str[pos] == '(') {
+            auto cpos = pos + 1;
+            // the payload is ASCII only so the result doesn't depend on the
+            // locale
+            while (cpos < length &&
+                   (isDigitCharacter(str[cpos]) ||
+                    (str[cpos] >= 'a' && str[cpos] <= 'z') ||
+                    (str[cpos] >= 'A' && str[cpos] <= 'Z') ||
+                    str[cpos] == '_')) {
+                ++cpos;
+            }
+            if (cpos < length && str[cpos] == ')') {
+                pos = cpos + 1;
+            }
+        }
+        index = pos;
+        return constants::invalid_conversion;
+    }
+    if (str[pos] == '0' && pos + 1 < length &&
+        (str[pos + 1] == 'x' || str[pos + 1] == 'X')) {
+        auto hpos = pos + 2;
+        value = readHexValue(str, length, hpos);
+        // without hex digits only the leading 0 is converted
+        index = (hpos == 0) ? pos + 1 : hpos;
+        return negative ? -value : value;
+    }
+    const auto numberStart = pos;
+    std::uint64_t mantissa{0};
+    int digits{0};
+    int exponent{0};
+    bool dropped{false};
+    bool sawDigit{false};
+    for (; pos < length && isDigitCharacter(str[pos]); ++pos) {
+        sawDigit = true;
+        if (digits < 19) {
+            if (mantissa == 0 && str[pos] == '0') {
+                continue;
+            }
+            mantissa =
+                mantissa * 10U + static_cast<std::uint64_t>(str[pos] - '0');
+            ++digits;
+        } else {
+            dropped = dropped || str[pos] != '0';
+            ++exponent;
+        }
+    }
+    if (pos < length && str[pos] == '.') {
+        ++pos;
+        for (; pos < length && isDigitCharacter(str[pos]); ++pos) {
+            sawDigit = true;
+            if (digits < 19) {
+                if (mantissa == 0 && str[pos] == '0') {
+                    --exponent;
+                    continue;
+                }
+                mantissa =
+                    mantissa * 10U + static_cast<std::uint64_t>(str[pos] - '0');
+                ++digits;
+                --exponent;
+            } else {
+                dropped = dropped || str[pos] != '0';
+            }
+        }
+    }
+    if (!sawDigit) {
+        return constants::invalid_conversion;
+    }
+    if (pos < length && (str[pos] == 'e' || str[pos] == 'E')) {
+        ++pos;
+        auto epos = pos;
+        readExponent(str, length, pos, exponent);
+        if (pos == epos) {
+            // no exponent digits so the 'e' is not part of the number
+            --pos;
+        }
+    }
+    index = pos;
+    if (mantissa == 0) {
+        value = 0.0;
+    } else if (
+        !dropped && mantissa <= (std::uint64_t{1} << 53U) && exponent >= -22 &&
+        exponent <= 22) {
+        // both values are exact so the result is correctly rounded
+        value = (exponent < 0) ?
+            static_cast<double>(mantissa) / exactPowers[-exponent] :
+            static_cast<double>(mantissa) * exactPowers[exponent];
+    } else {
+#ifdef UNITS_HAS_FLOAT_FROM_CHARS
+        auto res = std::from_chars(str + numberStart, str + pos, value);
+        if (res.ec == std::errc::result_out_of_range) {
+            value = (exponent + digits > 0) ? constants::infinity : 0.0;
+        }
+#else
+        value = slowDecimalConversion(str + numberStart, pos - numberStart);
+#endif
+    }
+    return negative ? -value : value;
+}
+
+/** a function very similar to stod that uses a locale independent parser and
+ * does things a little smarter for our case
+ */
+static double getDoubleFromString(
+    const char* str,
+    std::size_t length,
+    size_t* index) noexcept
+{
+    auto value = parseDouble(str, length, *index);
     // so if it converted anything then we can probably use that value if not
     // return NaN
     if (*index == 0) {
         return constants::invalid_conversion;
     }
-
-    if (vld > static_cast<long double>(std::numeric_limits<double>::max())) {
-        return constants::infinity;
-    }
-    if (vld < static_cast<long double>(-std::numeric_limits<double>::max())) {
-        return -constants::infinity;
-    }
     // floating point min gives you the smallest representable positive value
-    if (std::fabs(vld) <
-        static_cast<long double>(std::numeric_limits<double>::min())) {
+    if (std::fabs(value) < std::numeric_limits<double>::min()) {
         return 0.0;
     }
-    return static_cast<double>(vld);
+    return value;
+}
+
+static double
+    getDoubleFromString(const std::string& ustring, size_t* index) noexcept
+{
+    return getDoubleFromString(ustring.data(), ustring.size(), index);
 }
 
 /** generate a value from a single numerical block */
-static double getNumberBlock(const std::string& ustring, size_t& index) noexcept
+static double
+    getNumberBlock(const char* str, std::size_t length, size_t& index) noexcept
 {
     double val;
-    if (ustring.front() == '(') {
+    if (length == 0) {
+        return constants::invalid_conversion;
+    }
+    if (str[0] == '(') {
         size_t ival = 1;
-        if (segmentcheck(ustring, ')', ival)) {
+        if (segmentcheck(str, length, ')', ival)) {
             if (ival == 2) {
                 index = ival;
                 return 1.0;
             }
             bool hasOp = false;
             for (size_t ii = 1; ii < ival - 1; ++ii) {
-                auto c = ustring[ii];
+                auto c = str[ii];
                 if (c >= '0' && c <= '9') {
                     continue;
                 }
@@ -1954,14 +3783,14 @@ static double getNumberBlock(const std::string& ustring, size_t& index) noexcept
                         return constants::invalid_conversion;
                 }
             }
-            auto substr = ustring.substr(1, ival - 2);
+            const auto sublength = ival - 2;
             size_t ind;
             if (hasOp) {
-                val = generateLeadingNumber(substr, ind);
+                val = generateLeadingNumber(str + 1, sublength, ind);
             } else {
-                val = getDoubleFromString(substr, &ind);
+                val = getDoubleFromString(str + 1, sublength, &ind);
             }
-            if (ind < substr.size()) {
+            if (ind < sublength) {
                 return constants::invalid_conversion;
             }
             index = ival;
@@ -1969,12 +3798,13 @@ static double getNumberBlock(const std::string& ustring, size_t& index) noexcept
             return constants::invalid_conversion;
         }
     } else {
-        val = getDoubleFromString(ustring, &index);
+        val = getDoubleFromString(str, length, &index);
     }
-    if (!std::isnan(val) && index < ustring.size()) {
-        if (ustring[index] == '^') {
+    if (!std::isnan(val) && index < length) {
+        if (str[index] == '^') {
             size_t nindex{0};
-            double pval = getNumberBlock(ustring.substr(index + 1), nindex);
+            double pval =
+                getNumberBlock(str + index + 1, length - index - 1, nindex);
             if (!std::isnan(pval)) {
                 index += nindex + 1;
                 return std::pow(val, pval);
@@ -1986,18 +3816,21 @@ static double getNumberBlock(const std::string& ustring, size_t& index) noexcept
     return val;
 }
 
-double generateLeadingNumber(const std::string& ustring, size_t& index) noexcept
+static double generateLeadingNumber(
+    const char* str,
+    std::size_t length,
+    size_t& index) noexcept
 {
     index = 0;
-    double val = getNumberBlock(ustring, index);
+    double val = getNumberBlock(str, length, index);
     if (std::isnan(val)) {
         return val;
     }
     while (true) {
-        if (index >= ustring.size()) {
+        if (index >= length) {
             return val;
         }
-        switch (ustring[index]) {
+        switch (str[index]) {
             case '.':
             case '-':
             case '+':
@@ -2005,13 +3838,13 @@ double generateLeadingNumber(const std::string& ustring, size_t& index) noexcept
             case '/':
             case '*':
             case 'x':
-                if (looksLikeNumber(ustring, index + 1) ||
-                    ustring[index + 1] == '(') {
+                if (looksLikeNumber(str, length, index + 1) ||
+                    (index + 1 < length && str[index + 1] == '(')) {
                     size_t oindex{0};
-                    double res =
-                        getNumberBlock(ustring.substr(index + 1), oindex);
+                    double res = getNumberBlock(
+                        str + index + 1, length - index - 1, oindex);
                     if (!std::isnan(res)) {
-                        if (ustring[index] == '/') {
+                        if (str[index] == '/') {
                             val /= res;
                         } else {
                             val *= res;
@@ -2027,7 +3860,8 @@ double generateLeadingNumber(const std::string& ustring, size_t& index) noexcept
                 break;
             case '(': {
                 size_t oindex{0};
-                double res = getNumberBlock(ustring.substr(index), oindex);
+                double res =
+                    getNumberBlock(str + index, length - index, oindex);
                 if (!std::isnan(res)) {
                     val *= res;
                     index = oindex + index + 1;
@@ -2042,6 +3876,11 @@ double generateLeadingNumber(const std::string& ustring, size_t& index) noexcept
     }
 }
 
+double generateLeadingNumber(const std::string& ustring, size_t& index) noexcept
+{
+    return generateLeadingNumber(ustring.data(), ustring.size(), index);
+}
+
 // this string contains the first two letters of supported numerical words
 // static const std::string first_two =
 //    "on tw th fo fi si se ei ni te el hu mi bi tr ze";
@@ -2216,6 +4055,9 @@ static double readNumericalWords(const std::string& ustring, size_t& index)
 }
 
 #ifdef ENABLE_UNIT_TESTING
+static bool
+    cleanUnitString(std::string& unit_string, std::uint32_t match_flags);
+
 namespace detail {
     namespace testing {
         // generate a number from a number sequence
@@ -2234,9 +4076,16 @@ namespace detail {
             return generateUnitSequence(mul, test);
         }
         std::string
-            testCleanUpString(std::string testString, std::uint32_t commodity)
+            testCleanUpString(std::string testString, std::uint32_t commodity)
+        {
+            return clean_unit_string(std::move(testString), commodity);
+        }
+
+        std::string
+            testCleanUnitString(std::string testString, std::uint32_t flags)
         {
-            return clean_unit_string(std::move(testString), commodity);
+            cleanUnitString(testString, flags);
+            return testString;
         }
 
         void testAddUnitPower(
@@ -2452,6 +4301,56 @@ static bool wordModifiers(std::string& unit)
 }
 using ckpair = std::pair<const char*, const char*>;
 
+/// first byte dispatch over a table of search sequences so a single scan of
+/// a string finds the first table entry it contains
+template<std::size_t N>
+class SequenceDispatch {
+  public:
+    explicit SequenceDispatch(const std::array<ckpair, N>& table) :
+        sequences(table)
+    {
+        static_assert(N < 0xFFFFU, "sequence table is too large");
+        head.fill(0);
+        // build the chains in reverse so each chain is in table order
+        for (std::size_t ii = N; ii > 0; --ii) {
+            const auto* seq = sequences[ii - 1].first;
+            auto fbyte = static_cast<std::uint8_t>(seq[0]);
+            lengths[ii - 1] = strlen(seq);
+            next[ii - 1] = head[fbyte];
+            head[fbyte] = static_cast<std::uint16_t>(ii);
+        }
+    }
+    /** get the lowest table index at or after start whose sequence occurs in
+    str, or N if none of them do*/
+    std::size_t
+        firstPresent(const std::string& str, std::size_t start = 0) const
+    {
+        std::size_t best{N};
+        const auto* data = str.data();
+        const auto size = str.size();
+        for (std::size_t pos = 0; pos < size && best > start; ++pos) {
+            auto entry = head[static_cast<std::uint8_t>(data[pos])];
+            while (entry != 0 && entry <= best) {
+                auto index = static_cast<std::size_t>(entry - 1);
+                const auto len = lengths[index];
+                if (index >= start && len <= size - pos &&
+                    memcmp(data + pos, sequences[index].first, len) == 0) {
+                    best = index;
+                    break;
+                }
+                entry = next[index];
+            }
+        }
+        return best;
+    }
+
+  private:
+    const std::array<ckpair, N>& sequences;
+    std::array<std::uint16_t, 256> head;
+    std::array<std::uint16_t, N> next;
+    std::array<std::size_t, N> lengths;
+};
+
 static precise_unit
     localityModifiers(std::string unit, std::uint32_t match_flags)
 {
@@ -2502,22 +4401,22 @@ static precise_unit
             ckpair{"UK", "_br"},
             ckpair{"conventional", "_90"},
         }};
+    static const SequenceDispatch<44> internationalDispatch(
+        internationlReplacements);
     bool changed = false;
-    for (const auto& irep : internationlReplacements) {
-        auto fnd = unit.find(irep.first);
-        if (fnd != std::string::npos) {
-            auto len = strlen(irep.first);
-            if (len == unit.size()) {  // this is a modifier if we are checking
-                                       // the entire unit this is automatically
-                                       // false
-                return precise::invalid;
-            }
-            unit.erase(fnd, len);
-
-            unit.append(irep.second);
-            changed = true;
-            break;
+    auto rindex = internationalDispatch.firstPresent(unit);
+    if (rindex < internationlReplacements.size()) {
+        const auto& irep = internationlReplacements[rindex];
+        auto len = strlen(irep.first);
+        if (len == unit.size()) {  // this is a modifier if we are checking
+                                   // the entire unit this is automatically
+                                   // false
+            return precise::invalid;
         }
+        unit.erase(unit.find(irep.first), len);
+
+        unit.append(irep.second);
+        changed = true;
     }
     changed |= clearEmptySegments(unit);
     if (changed) {
@@ -2600,26 +4499,208 @@ static std::pair<double, size_t>
     return {0.0, 0};
 }
 
-static smap loadDefinedUnits()
+/** hash a string for use in a FlatTableIndex (FNV-1a)*/
+static std::uint32_t flatHash(const char* str, std::size_t length)
+{
+    std::uint32_t hash{2166136261U};
+    for (std::size_t ii = 0; ii < length; ++ii) {
+        hash ^= static_cast<unsigned char>(str[ii]);
+        hash *= 16777619U;
+    }
+    return hash;
+}
+
+/** check if a null terminated key matches a character buffer exactly*/
+static bool keyEquals(const char* key, const char* str, std::size_t length)
 {
-    smap knownUnits;
-    for (auto& pr : defined_unit_strings_si) {
-        if (pr.first != nullptr) {
-            knownUnits.emplace(pr.first, pr.second);
+    for (std::size_t ii = 0; ii < length; ++ii) {
+        if (key[ii] != str[ii] || key[ii] == '\0') {
+            return false;
+        }
+    }
+    return key[length] == '\0';
+}
+
+/** open addressing index of the positions of entries in a constant table
+@details the index is a single block of integers with no allocations, each
+occupied slot holds the upper 16 bits of the hash and the table position + 1
+in the lower 16 bits so most mismatches are rejected without touching the
+table itself
+*/
+template<std::size_t SLOTS>
+class FlatTableIndex {
+  public:
+    static constexpr std::size_t npos{static_cast<std::size_t>(-1)};
+
+    FlatTableIndex() { slots.fill(0U); }
+    /// find the table position of an entry, match verifies a candidate
+    template<typename MATCH>
+    std::size_t find(std::uint32_t hash, MATCH match) const
+    {
+        const std::uint32_t tag = hash & 0xFFFF0000U;
+        for (auto loc = hash & mask; slots[loc] != 0U; loc = (loc + 1) & mask) {
+            if ((slots[loc] & 0xFFFF0000U) == tag) {
+                std::size_t index = (slots[loc] & 0xFFFFU) - 1U;
+                if (match(index)) {
+                    return index;
+                }
+            }
+        }
+        return npos;
+    }
+    /// add a table position to the index
+    void insert(std::uint32_t hash, std::size_t index)
+    {
+        auto loc = hash & mask;
+        while (slots[loc] != 0U) {
+            loc = (loc + 1) & mask;
         }
+        slots[loc] =
+            (hash & 0xFFFF0000U) | static_cast<std::uint32_t>(index + 1U);
     }
-    for (auto& pr : defined_unit_strings_customary) {
-        if (pr.first != nullptr) {
-            knownUnits.emplace(pr.first, pr.second);
+
+  private:
+    static_assert(
+        SLOTS <= 0x10000U && (SLOTS & (SLOTS - 1)) == 0,
+        "index size must be a power of 2 that fits in 16 bits");
+    static constexpr std::uint32_t mask{static_cast<std::uint32_t>(SLOTS - 1)};
+    std::array<std::uint32_t, SLOTS> slots;
+};
+
+using unitStringEntry = std::pair<const char*, precise_unit>;
+
+static constexpr std::size_t siUnitStringCount{
+    std::tuple_size<decltype(defined_unit_strings_si)>::value};
+static constexpr std::size_t definedUnitStringCount{
+    siUnitStringCount +
+    std::tuple_size<decltype(defined_unit_strings_customary)>::value};
+
+/** get an entry from the combined si and customary unit string tables*/
+static const unitStringEntry& definedUnitString(std::size_t index)
+{
+    return (index < siUnitStringCount) ?
+        defined_unit_strings_si[index] :
+        defined_unit_strings_customary[index - siUnitStringCount];
+}
+
+/** build an index over a table of string keys, the first occurrence of a key
+is the one that gets indexed*/
+template<std::size_t SLOTS, typename ENTRY>
+static void indexTable(
+    FlatTableIndex<SLOTS>& index,
+    std::size_t entries,
+    ENTRY entry)
+{
+    for (std::size_t ii = 0; ii < entries; ++ii) {
+        const char* key = entry(ii).first;
+        if (key == nullptr) {
+            continue;
+        }
+        auto len = strlen(key);
+        auto hash = flatHash(key, len);
+        auto match = [&entry, key, len](std::size_t loc) {
+            return keyEquals(entry(loc).first, key, len);
+        };
+        if (index.find(hash, match) == FlatTableIndex<SLOTS>::npos) {
+            index.insert(hash, ii);
         }
     }
-    return knownUnits;
 }
+
+using definedUnitIndex = FlatTableIndex<4096>;
+static_assert(
+    definedUnitStringCount < 4096 * 3 / 4,
+    "the defined unit index needs to be enlarged");
+
 /** units from several locations
 http://vizier.u-strasbg.fr/vizier/doc/catstd-3.2.htx
 http://unitsofmeasure.org/ucum.html#si
+the index over the tables is generated on first use
 */
-static const smap base_unit_vals = loadDefinedUnits();
+static const definedUnitIndex& getDefinedUnitIndex()
+{
+    static const definedUnitIndex unitIndex = []() {
+        definedUnitIndex index;
+        indexTable(index, definedUnitStringCount, definedUnitString);
+        return index;
+    }();
+    return unitIndex;
+}
+
+/** find a unit in the defined unit tables
+@return a pointer to the unit or nullptr if not found*/
+static const precise_unit*
+    findDefinedUnit(const char* unit_string, std::size_t length)
+{
+    const auto& index = getDefinedUnitIndex();
+    auto loc = index.find(
+        flatHash(unit_string, length), [unit_string, length](std::size_t ii) {
+            return keyEquals(definedUnitString(ii).first, unit_string, length);
+        });
+    return (loc != definedUnitIndex::npos) ? &definedUnitString(loc).second :
+                                             nullptr;
+}
+
+// NOTE no unit strings with '/' in it this can cause issues when converting to
+// string with out-of-order operations
+using unitNameEntry = std::pair<unit, const char*>;
+using unitNameIndex = FlatTableIndex<512>;
+static_assert(
+    std::tuple_size<decltype(defined_unit_names)>::value < 512 * 3 / 4,
+    "the unit name index needs to be enlarged");
+
+/** hash the base units and the rounded multiplier of a unit, units which
+compare equal with the same rounded multiplier have the same hash*/
+static std::uint32_t unitNameHash(const unit& un)
+{
+    auto base = un.base_units();
+    // +0.0 and -0.0 need the same hash
+    float rounded = (un.cround() == 0.0F) ? 0.0F : un.cround();
+    char bytes[sizeof(base) + sizeof(rounded)];
+    std::memcpy(bytes, &base, sizeof(base));
+    std::memcpy(bytes + sizeof(base), &rounded, sizeof(rounded));
+    return flatHash(bytes, sizeof(bytes));
+}
+
+/** check if a unit matches a key of the unit name index*/
+static bool unitNameMatch(const unit& key, const unit& un)
+{
+    return key.base_units() == un.base_units() &&
+        (key.cround() == un.cround()) && key == un;
+}
+
+/** the index over the defined unit names is generated on first use, the first
+name listed for a unit is the one used*/
+static const unitNameIndex& getUnitNameIndex()
+{
+    static const unitNameIndex nameIndex = []() {
+        unitNameIndex index;
+        for (std::size_t ii = 0; ii < defined_unit_names.size(); ++ii) {
+            const auto& entry = defined_unit_names[ii];
+            if (entry.second == nullptr) {
+                continue;
+            }
+            auto hash = unitNameHash(entry.first);
+            auto match = [&entry](std::size_t loc) {
+                return unitNameMatch(
+                    defined_unit_names[loc].first, entry.first);
+            };
+            if (index.find(hash, match) == unitNameIndex::npos) {
+                index.insert(hash, ii);
+            }
+        }
+        return index;
+    }();
+    return nameIndex;
+}
+
+static const unitNameEntry* findUnitName(const unit& un)
+{
+    auto loc = getUnitNameIndex().find(unitNameHash(un), [&un](std::size_t ii) {
+        return unitNameMatch(defined_unit_names[ii].first, un);
+    });
+    return (loc != unitNameIndex::npos) ? &defined_unit_names[loc] : nullptr;
+}
 
 // LCOV_EXCL_START
 
@@ -2706,7 +4787,16 @@ static bool
 static bool
     segmentcheck(const std::string& unit, char closeSegment, size_t& index)
 {
-    while (index < unit.size()) {
+    return segmentcheck(unit.data(), unit.size(), closeSegment, index);
+}
+
+static bool segmentcheck(
+    const char* unit,
+    std::size_t length,
+    char closeSegment,
+    size_t& index)
+{
+    while (index < length) {
         char current = unit[index];
         ++index;
         if (current == closeSegment) {
@@ -2718,7 +4808,8 @@ static bool
                 break;
             case '(':
             case '"':
-                if (!segmentcheck(unit, getMatchCharacter(current), index)) {
+                if (!segmentcheck(
+                        unit, length, getMatchCharacter(current), index)) {
                     return false;
                 }
                 break;
@@ -2728,7 +4819,7 @@ static bool
                 if (close == closeSegment) {
                     return false;
                 }
-                if (!segmentcheck(unit, close, index)) {
+                if (!segmentcheck(unit, length, close, index)) {
                     return false;
                 }
                 break;
@@ -2792,14 +4883,14 @@ static precise_unit
         static_cast<size_t>(ccindex) + 2, finish - ccindex - 2);
 
     if (ccindex < 0) {
-        return {1.0, precise::one, getCommodity(cstring)};
+        return {1.0, precise::one, getCommodity(std::move(cstring))};
     }
 
     auto bunit = unit_from_string_internal(
         unit_string.substr(0, static_cast<size_t>(ccindex) + 1),
         match_flags + no_commodities);
     if (!is_error(bunit)) {
-        return {1.0, bunit, getCommodity(cstring)};
+        return {1.0, bunit, getCommodity(std::move(cstring))};
     }
     return precise::invalid;
 }
@@ -2812,66 +4903,208 @@ static bool hasAdditionalOps(const std::string& unit_string)
          std::string::npos);
 }
 
-static std::uint64_t hashGen(std::uint32_t index, const std::string& str)
-{
-    return std::hash<std::string>{}(str) ^ std::hash<std::uint32_t>{}(index);
-}
-
-static const std::unordered_map<std::uint64_t, precise_unit> domainSpecificUnit{
-    {hashGen(domains::ucum, "B"), precise::log::bel},
-    {hashGen(domains::ucum, "a"), precise::time::aj},
-    {hashGen(domains::ucum, "year"), precise::time::aj},
-    {hashGen(domains::astronomy, "am"), precise::angle::arcmin},
-    {hashGen(domains::astronomy, "as"), precise::angle::arcsec},
-    {hashGen(domains::astronomy, "year"), precise::time::at},
-    {hashGen(domains::cooking, "C"), precise::us::cup},
-    {hashGen(domains::cooking, "T"), precise::us::tbsp},
-    {hashGen(domains::cooking, "c"), precise::us::cup},
-    {hashGen(domains::cooking, "t"), precise::us::tsp},
-    {hashGen(domains::cooking, "TB"), precise::us::tbsp},
-    {hashGen(domains::surveying, "'"), precise::us::foot},
-    {hashGen(domains::surveying, "`"), precise::us::foot},
-    {hashGen(domains::surveying, u8"\u2032"), precise::us::foot},
-    {hashGen(domains::surveying, "''"), precise::us::inch},
-    {hashGen(domains::surveying, "``"), precise::us::inch},
-    {hashGen(domains::surveying, "\""), precise::us::inch},
-    {hashGen(domains::surveying, u8"\u2033"), precise::us::inch},
-    {hashGen(domains::nuclear, "rad"), precise::cgs::RAD},
-    {hashGen(domains::nuclear, "rd"), precise::cgs::RAD},
-    {hashGen(domains::climate, "kt"), precise::kilo* precise::t},
-    {hashGen(domains::us_customary, "C"), precise::us::cup},
-    {hashGen(domains::us_customary, "T"), precise::us::tbsp},
-    {hashGen(domains::us_customary, "c"), precise::us::cup},
-    {hashGen(domains::us_customary, "t"), precise::us::tsp},
-    {hashGen(domains::us_customary, "TB"), precise::us::tbsp},
-    {hashGen(domains::us_customary, "'"), precise::us::foot},
-    {hashGen(domains::us_customary, "`"), precise::us::foot},
-    {hashGen(domains::us_customary, u8"\u2032"), precise::us::foot},
-    {hashGen(domains::us_customary, "''"), precise::us::inch},
-    {hashGen(domains::us_customary, "``"), precise::us::inch},
-    {hashGen(domains::us_customary, "\""), precise::us::inch},
-    {hashGen(domains::us_customary, u8"\u2033"), precise::us::inch},
-    {hashGen(domains::allDomains, "B"), precise::log::bel},
-    {hashGen(domains::allDomains, "a"), precise::time::aj},
-    {hashGen(domains::allDomains, "year"), precise::time::aj},
-    {hashGen(domains::allDomains, "am"), precise::angle::arcmin},
-    {hashGen(domains::allDomains, "as"), precise::angle::arcsec},
-    {hashGen(domains::allDomains, "C"), precise::us::cup},
-    {hashGen(domains::allDomains, "T"), precise::us::tbsp},
-    {hashGen(domains::allDomains, "c"), precise::us::cup},
-    {hashGen(domains::allDomains, "t"), precise::us::tsp},
-    {hashGen(domains::allDomains, "TB"), precise::us::tbsp},
-    {hashGen(domains::allDomains, "rad"), precise::cgs::RAD},
-    {hashGen(domains::allDomains, "kt"), precise::kilo* precise::t},
-    {hashGen(domains::allDomains, "rd"), precise::cgs::RAD}};
+using domainUnitString = std::tuple<std::uint32_t, const char*, precise_unit>;
+
+static UNITS_CPP14_CONSTEXPR_OBJECT std::array<domainUnitString, 46>
+    domainSpecificUnit{{
+        domainUnitString{domains::ucum, "B", precise::log::bel},
+        domainUnitString{domains::ucum, "a", precise::time::aj},
+        domainUnitString{domains::ucum, "year", precise::time::aj},
+        domainUnitString{domains::astronomy, "am", precise::angle::arcmin},
+        domainUnitString{domains::astronomy, "as", precise::angle::arcsec},
+        domainUnitString{domains::astronomy, "year", precise::time::at},
+        domainUnitString{domains::cooking, "C", precise::us::cup},
+        domainUnitString{domains::cooking, "T", precise::us::tbsp},
+        domainUnitString{domains::cooking, "c", precise::us::cup},
+        domainUnitString{domains::cooking, "t", precise::us::tsp},
+        domainUnitString{domains::cooking, "TB", precise::us::tbsp},
+        domainUnitString{domains::surveying, "'", precise::us::foot},
+        domainUnitString{domains::surveying, "`", precise::us::foot},
+        domainUnitString{domains::surveying, u8"\u2032", precise::us::foot},
+        domainUnitString{domains::surveying, "''", precise::us::inch},
+        domainUnitString{domains::surveying, "``", precise::us::inch},
+        domainUnitString{domains::surveying, "\"", precise::us::inch},
+        domainUnitString{domains::surveying, u8"\u2033", precise::us::inch},
+        domainUnitString{domains::nuclear, "rad", precise::cgs::RAD},
+        domainUnitString{domains::nuclear, "rd", precise::cgs::RAD},
+        domainUnitString{domains::climate, "kt", precise::kilo* precise::t},
+        domainUnitString{domains::us_customary, "C", precise::us::cup},
+        domainUnitString{domains::us_customary, "T", precise::us::tbsp},
+        domainUnitString{domains::us_customary, "c", precise::us::cup},
+        domainUnitString{domains::us_customary, "t", precise::us::tsp},
+        domainUnitString{domains::us_customary, "TB", precise::us::tbsp},
+        domainUnitString{domains::us_customary, "'", precise::us::foot},
+        domainUnitString{domains::us_customary, "`", precise::us::foot},
+        domainUnitString{domains::us_customary, u8"\u2032", precise::us::foot},
+        domainUnitString{domains::us_customary, "''", precise::us::inch},
+        domainUnitString{domains::us_customary, "``", precise::us::inch},
+        domainUnitString{domains::us_customary, "\"", precise::us::inch},
+        domainUnitString{domains::us_customary, u8"\u2033", precise::us::inch},
+        domainUnitString{domains::allDomains, "B", precise::log::bel},
+        domainUnitString{domains::allDomains, "a", precise::time::aj},
+        domainUnitString{domains::allDomains, "year", precise::time::aj},
+        domainUnitString{domains::allDomains, "am", precise::angle::arcmin},
+        domainUnitString{domains::allDomains, "as", precise::angle::arcsec},
+        domainUnitString{domains::allDomains, "C", precise::us::cup},
+        domainUnitString{domains::allDomains, "T", precise::us::tbsp},
+        domainUnitString{domains::allDomains, "c", precise::us::cup},
+        domainUnitString{domains::allDomains, "t", precise::us::tsp},
+        domainUnitString{domains::allDomains, "TB", precise::us::tbsp},
+        domainUnitString{domains::allDomains, "rad", precise::cgs::RAD},
+        domainUnitString{domains::allDomains, "kt", precise::kilo* precise::t},
+        domainUnitString{domains::allDomains, "rd", precise::cgs::RAD}}};
+
+using domainUnitIndex = FlatTableIndex<128>;
+
+// hash a unit string for a specific domain
+static std::uint32_t
+    domainHash(std::uint32_t domain, const char* str, std::size_t length)
+{
+    return flatHash(str, length) ^ (domain * 0x9E3779B1U);
+}
+
+static const domainUnitIndex& getDomainUnitIndex()
+{
+    static const domainUnitIndex unitIndex = []() {
+        domainUnitIndex index;
+        for (std::size_t ii = 0; ii < domainSpecificUnit.size(); ++ii) {
+            const auto& dunit = domainSpecificUnit[ii];
+            index.insert(
+                domainHash(
+                    std::get<0>(dunit),
+                    std::get<1>(dunit),
+                    strlen(std::get<1>(dunit))),
+                ii);
+        }
+        return index;
+    }();
+    return unitIndex;
+}
 
 static precise_unit
     getDomainUnit(std::uint32_t domain, const std::string& unit_string)
 {
-    auto h1 = hashGen(domain, unit_string);
-    auto fnd = domainSpecificUnit.find(h1);
-    return (fnd != domainSpecificUnit.end()) ? fnd->second : precise::invalid;
+    auto loc = getDomainUnitIndex().find(
+        domainHash(domain, unit_string.data(), unit_string.size()),
+        [domain, &unit_string](std::size_t ii) {
+            return std::get<0>(domainSpecificUnit[ii]) == domain &&
+                keyEquals(
+                    std::get<1>(domainSpecificUnit[ii]),
+                    unit_string.data(),
+                    unit_string.size());
+        });
+    return (loc != domainUnitIndex::npos) ?
+        std::get<2>(domainSpecificUnit[loc]) :
+        precise::invalid;
+}
+/** a trie over all the defined and domain specific unit strings stored in
+flat arrays, it is used to find which leading segments of a string could
+possibly be matched as a unit in a single walk
+*/
+class UnitNameTrie {
+  public:
+    /// the longest string which can be checked
+    static constexpr std::size_t maxLength{1024};
+    using segment_set = std::bitset<maxLength + 1>;
+
+    UnitNameTrie()
+    {
+        // build with per node child lists then flatten
+        std::vector<std::vector<std::pair<char, std::uint32_t>>> children(1);
+        std::vector<bool> terminal(1, false);
+        auto addKey = [&children, &terminal](const char* key) {
+            std::uint32_t current{0};
+            for (; *key != '\0'; ++key) {
+                auto& kids = children[current];
+                auto fnd = std::find_if(
+                    kids.begin(),
+                    kids.end(),
+                    [key](const std::pair<char, std::uint32_t>& edge) {
+                        return edge.first == *key;
+                    });
+                if (fnd != kids.end()) {
+                    current = fnd->second;
+                    continue;
+                }
+                auto next = static_cast<std::uint32_t>(children.size());
+                kids.emplace_back(*key, next);
+                children.emplace_back();
+                terminal.push_back(false);
+                current = next;
+            }
+            terminal[current] = true;
+        };
+        for (std::size_t ii = 0; ii < definedUnitStringCount; ++ii) {
+            if (definedUnitString(ii).first != nullptr) {
+                addKey(definedUnitString(ii).first);
+            }
+        }
+        for (const auto& dunit : domainSpecificUnit) {
+            addKey(std::get<1>(dunit));
+        }
+        nodes.resize(children.size());
+        for (std::size_t ii = 0; ii < children.size(); ++ii) {
+            auto& kids = children[ii];
+            std::sort(kids.begin(), kids.end());
+            nodes[ii].firstEdge = static_cast<std::uint32_t>(edges.size());
+            nodes[ii].edgeCount = static_cast<std::uint32_t>(kids.size());
+            nodes[ii].terminal = terminal[ii];
+            edges.insert(edges.end(), kids.begin(), kids.end());
+        }
+    }
+    /** mark the lengths of the leading segments of str which could be quick
+    matched as a unit, including a trailing 's' plural
+    @param lowerFirst treat the first character as lower case*/
+    void markSegments(
+        const std::string& str,
+        bool lowerFirst,
+        segment_set& segments) const
+    {
+        const auto length = (str.size() < maxLength) ? str.size() : maxLength;
+        std::uint32_t current{0};
+        for (std::size_t pos = 0; pos < length; ++pos) {
+            auto c = str[pos];
+            if (pos == 0 && lowerFirst && c >= 'A' && c <= 'Z') {
+                c += 32;
+            }
+            auto first = edges.begin() + nodes[current].firstEdge;
+            auto last = first + nodes[current].edgeCount;
+            auto fnd = std::lower_bound(
+                first,
+                last,
+                c,
+                [](const std::pair<char, std::uint32_t>& edge, char val) {
+                    return edge.first < val;
+                });
+            if (fnd == last || fnd->first != c) {
+                return;
+            }
+            current = fnd->second;
+            if (nodes[current].terminal) {
+                segments.set(pos + 1);
+                if (pos > 0 && pos + 1 < length && str[pos + 1] == 's') {
+                    segments.set(pos + 2);
+                }
+            }
+        }
+    }
+
+  private:
+    struct trie_node {
+        std::uint32_t firstEdge{0};
+        std::uint32_t edgeCount{0};
+        bool terminal{false};
+    };
+    std::vector<trie_node> nodes;
+    std::vector<std::pair<char, std::uint32_t>> edges;
+};
+
+static const UnitNameTrie& getUnitNameTrie()
+{
+    static const UnitNameTrie trie;
+    return trie;
 }
+
 static std::uint32_t getCurrentDomain(std::uint32_t match_flags)
 {
     auto dmn = match_flags & 0x00F8U;
@@ -2883,9 +5116,11 @@ static precise_unit
     get_unit(const std::string& unit_string, std::uint32_t match_flags)
 {
     if (allowUserDefinedUnits.load(std::memory_order_acquire)) {
-        if (!user_defined_units.empty()) {
-            auto fnd2 = user_defined_units.find(unit_string);
-            if (fnd2 != user_defined_units.end()) {
+        UserDefinedScope userDefined;
+        if (userDefined.hasUnits()) {
+            const auto& userUnits = userDefined.get()->units;
+            auto fnd2 = userUnits.find(unit_string);
+            if (fnd2 != userUnits.end()) {
                 return fnd2->second;
             }
         }
@@ -2899,9 +5134,9 @@ static precise_unit
         }
     }
 
-    auto fnd = base_unit_vals.find(unit_string);
-    if (fnd != base_unit_vals.end()) {
-        return fnd->second;
+    const auto* fnd = findDefinedUnit(unit_string.data(), unit_string.size());
+    if (fnd != nullptr) {
+        return *fnd;
     }
     auto c = unit_string.front();
     if ((c == 'C' || c == 'E') && unit_string.size() >= 6) {
@@ -2950,13 +5185,19 @@ static precise_unit
 // Detect if a string looks like a number
 static bool looksLikeNumber(const std::string& string, size_t index)
 {
-    if (string.size() <= index) {
+    return looksLikeNumber(string.data(), string.size(), index);
+}
+
+static bool
+    looksLikeNumber(const char* string, std::size_t length, size_t index)
+{
+    if (length <= index) {
         return false;
     }
     if (isDigitCharacter(string[index])) {
         return true;
     }
-    if (string.size() < index + 2) {
+    if (length < index + 2) {
         return false;
     }
     if (string[index] == '.' &&
@@ -2967,7 +5208,7 @@ static bool looksLikeNumber(const std::string& string, size_t index)
         if (string[index + 1] >= '0' && string[index + 1] <= '9') {
             return true;
         }
-        if (string.size() >= index + 3 && string[index + 1] == '.' &&
+        if (length >= index + 3 && string[index + 1] == '.' &&
             (string[index + 2] >= '0' && string[index + 2] <= '9')) {
             return true;
         }
@@ -3646,8 +5887,15 @@ static bool unicodeReplacement(std::string& unit_string)
             ckpair{"\xBC", "(0.25)"},  // (1/4) fraction
             ckpair{"\xBE", "(0.75)"},  // (3/4) fraction
         }};
+    static const SequenceDispatch<66> ucodeDispatch(ucodeReplacements);
     bool changed{false};
-    for (auto& ucode : ucodeReplacements) {
+    // only the sequences actually present get a search, the dispatch scan
+    // is repeated after each applied sequence since replacements can create
+    // later sequences
+    for (auto ii = ucodeDispatch.firstPresent(unit_string);
+         ii < ucodeReplacements.size();
+         ii = ucodeDispatch.firstPresent(unit_string, ii + 1)) {
+        const auto& ucode = ucodeReplacements[ii];
         auto fnd = unit_string.find(ucode.first);
         while (fnd != std::string::npos) {
             changed = true;
@@ -3828,6 +6076,7 @@ static bool cleanUnitString(std::string& unit_string, std::uint32_t match_flags)
             ckpair{"Hz^1/2", "rootHertz"},
             ckpair{u8"\u221AHz", "rootHertz"},
         }};
+    static const SequenceDispatch<30> allCodeDispatch(allCodeReplacements);
 
     static const std::string spchar = std::string(" \t\n\r") + '\0';
     bool changed = false;
@@ -3853,16 +6102,17 @@ static bool cleanUnitString(std::string& unit_string, std::uint32_t match_flags)
         changed = true;
         skipMultiply = true;
     }
+    // passes whose trigger characters are not present are skipped
+    auto classes = characterClasses(unit_string);
     if (!skipcodereplacement) {
         // Check for unicode or extended characters
-        if (std::any_of(unit_string.begin(), unit_string.end(), [](char x) {
-                return (static_cast<std::uint8_t>(x) & 0x80U) != 0;
-            })) {
+        if ((classes & high_bit_characters) != 0) {
             if (unicodeReplacement(unit_string)) {
                 changed = true;
+                classes = characterClasses(unit_string);
             }
         }
-        if (unit_string.find_first_of(spchar) != std::string::npos) {
+        if ((classes & space_characters) != 0) {
             // deal with some particular string with a space in them
 
             // clean up some "per" words
@@ -3894,7 +6144,9 @@ static bool cleanUnitString(std::string& unit_string, std::uint32_t match_flags)
             }
         }
 
-        checkPowerOf10(unit_string);
+        if ((classes & digit_characters) != 0) {
+            checkPowerOf10(unit_string);
+        }
     } else {
         auto fndP = unit_string.find("of(");
         if (fndP != std::string::npos) {
@@ -3920,12 +6172,15 @@ static bool cleanUnitString(std::string& unit_string, std::uint32_t match_flags)
     }
     if (!skipcodereplacement) {
         // deal with some html stuff
-        auto bloc = unit_string.find_last_of('<');
-        if (bloc != std::string::npos) {
+        if ((classes & bracket_characters) != 0 &&
+            unit_string.find_last_of('<') != std::string::npos) {
             htmlCodeReplacement(unit_string);
         }
         // some abbreviations and other problematic code replacements
-        for (auto& acode : allCodeReplacements) {
+        for (auto ii = allCodeDispatch.firstPresent(unit_string);
+             ii < allCodeReplacements.size();
+             ii = allCodeDispatch.firstPresent(unit_string, ii + 1)) {
+            const auto& acode = allCodeReplacements[ii];
             auto fnd = unit_string.find(acode.first);
             while (fnd != std::string::npos) {
                 changed = true;
@@ -3966,6 +6221,8 @@ static bool cleanUnitString(std::string& unit_string, std::uint32_t match_flags)
             }
         }
     }
+    // the replacements above can introduce brackets and powers
+    classes = characterClasses(unit_string);
     if (!skipcodereplacement) {
         // handle dot notation for multiplication
         auto dotloc = unit_string.find_last_of('.');
@@ -3977,24 +6234,28 @@ static bool cleanUnitString(std::string& unit_string, std::uint32_t match_flags)
             }
         }
 
-        // clear empty parenthesis
-        auto fndP = unit_string.find("()");
-        while (fndP != std::string::npos) {
-            if (unit_string.size() > fndP + 2) {
-                if (unit_string[fndP + 2] == '^') {
-                    unit_string.replace(fndP, 2, "*1");
+        if ((classes & bracket_characters) != 0) {
+            // clear empty parenthesis
+            auto fndP = unit_string.find("()");
+            while (fndP != std::string::npos) {
+                if (unit_string.size() > fndP + 2) {
+                    if (unit_string[fndP + 2] == '^') {
+                        unit_string.replace(fndP, 2, "*1");
+                    } else {
+                        unit_string.erase(fndP, 2);
+                    }
                 } else {
                     unit_string.erase(fndP, 2);
                 }
-            } else {
-                unit_string.erase(fndP, 2);
+                fndP = unit_string.find("()", fndP);
             }
-            fndP = unit_string.find("()", fndP);
+            // clear empty brackets, this would indicate commodities but if
+            // empty there is no commodity
+            clearEmptySegments(unit_string);
+        }
+        if ((classes & caret_characters) != 0) {
+            cleanUpPowersOfOne(unit_string);
         }
-        // clear empty brackets, this would indicate commodities but if
-        // empty there is no commodity
-        clearEmptySegments(unit_string);
-        cleanUpPowersOfOne(unit_string);
         if (unit_string.empty()) {
             unit_string.push_back('1');
             return true;
@@ -4016,7 +6277,9 @@ static bool cleanUnitString(std::string& unit_string, std::uint32_t match_flags)
         }
     }
     // inject multiplies after bracket terminators
-    auto fnd = unit_string.find_first_of(")]}");
+    auto fnd = ((classes & bracket_characters) != 0) ?
+        unit_string.find_first_of(")]}") :
+        std::string::npos;
     while (fnd < unit_string.size() - 1 && fnd < skipMultiplyInsertionAfter) {
         switch (unit_string[fnd + 1]) {
             case '^':
@@ -4058,7 +6321,8 @@ static bool cleanUnitString(std::string& unit_string, std::uint32_t match_flags)
         }
     }
     // insert multiplies after ^#
-    fnd = unit_string.find_first_of('^');
+    fnd = ((classes & caret_characters) != 0) ? unit_string.find_first_of('^') :
+                                                std::string::npos;
     while (fnd < unit_string.size() - 3 && fnd < skipMultiplyInsertionAfter) {
         if (unit_string[fnd + 1] == '-') {
             ++fnd;
@@ -4090,7 +6354,8 @@ static bool cleanUnitString(std::string& unit_string, std::uint32_t match_flags)
         unit_string.insert(unit_string.begin(), '1');
         changed = true;
     }
-    if (!skipcodereplacement) {  // make everything inside {} lower case
+    if (!skipcodereplacement && (classes & bracket_characters) != 0) {
+        // make everything inside {} lower case
         auto bloc = unit_string.find_first_of('{');
         while (bloc != std::string::npos) {
             auto ind = bloc + 1;
@@ -4137,32 +6402,29 @@ static bool cleanUnitStringPhase2(std::string& unit_string)
     return (len != unit_string.length());
 }
 
-static precise_unit
-    unit_quick_match(std::string unit_string, std::uint32_t match_flags)
+// quick match on a string that needs no further cleaning
+static precise_unit unit_quick_match_cleaned(
+    const std::string& unit_string,
+    std::uint32_t match_flags)
 {
-    if ((match_flags & case_insensitive) != 0) {  // if not a case insensitive
-                                                  // matching process just do a
-                                                  // quick scan first
-        cleanUnitString(unit_string, match_flags);
-    }
     auto retunit = get_unit(unit_string, match_flags);
     if (is_valid(retunit)) {
         return retunit;
     }
-    if (unit_string.size() > 2 &&
-        unit_string.back() == 's') {  // if the string is of length two this
-                                      // is too risky to try since there
-                                      // would be many incorrect matches
-        unit_string.pop_back();
-        retunit = get_unit(unit_string, match_flags);
+    auto len = unit_string.size();
+    if (len > 2 && unit_string.back() == 's') {
+        // if the string is of length two this is too risky to try since there
+        // would be many incorrect matches
+        retunit = get_unit(unit_string.substr(0, len - 1), match_flags);
         if (is_valid(retunit)) {
             return retunit;
         }
     } else if (unit_string.front() == '[' && unit_string.back() == ']') {
-        unit_string.pop_back();
-        if (unit_string.back() != 'U' && unit_string.back() != 'u') {
-            unit_string.erase(unit_string.begin());
-            retunit = get_unit(unit_string, match_flags);
+        if (len < 2 ||
+            (unit_string[len - 2] != 'U' && unit_string[len - 2] != 'u')) {
+            retunit = get_unit(
+                (len > 2) ? unit_string.substr(1, len - 2) : std::string(),
+                match_flags);
             if (is_valid(retunit)) {
                 return retunit;
             }
@@ -4170,6 +6432,18 @@ static precise_unit
     }
     return precise::invalid;
 }
+
+static precise_unit
+    unit_quick_match(const std::string& unit_string, std::uint32_t match_flags)
+{
+    if ((match_flags & case_insensitive) != 0) {
+        // only a case insensitive matching process needs a cleaned copy
+        std::string cleaned(unit_string);
+        cleanUnitString(cleaned, match_flags);
+        return unit_quick_match_cleaned(cleaned, match_flags);
+    }
+    return unit_quick_match_cleaned(unit_string, match_flags);
+}
 /** Under the assumption units were mashed together to for some new work or
 spaces were used as multiplies this function will progressively try to split
 apart units and combine them.
@@ -4178,13 +6452,14 @@ static precise_unit tryUnitPartitioning(
     const std::string& unit_string,
     std::uint32_t match_flags)
 {
-    std::string ustring = unit_string;
+    std::string ustring;
     // lets try checking for meter next which is one of the most common
     // reasons for getting here
     auto fnd = findWordOperatorSep(unit_string, "meter");
     if (fnd != std::string::npos) {
+        ustring = unit_string;
         ustring.erase(fnd, 5);
-        auto bunit = unit_from_string_internal(ustring, match_flags);
+        auto bunit = unit_from_string_internal(std::move(ustring), match_flags);
         if (is_valid(bunit)) {
             return precise::m * bunit;
         }
@@ -4199,9 +6474,8 @@ static precise_unit tryUnitPartitioning(
     }
     auto mret = getPrefixMultiplierWord(unit_string);
     if (mret.first != 0.0) {
-        ustring = unit_string.substr(mret.second);
-
-        auto retunit = unit_from_string_internal(ustring, match_flags);
+        auto retunit = unit_from_string_internal(
+            unit_string.substr(mret.second), match_flags);
         if (is_valid(retunit)) {
             return {mret.first, retunit};
         }
@@ -4217,16 +6491,44 @@ static precise_unit tryUnitPartitioning(
         part = 1;
         ustring.pop_back();
     }
+    // find the leading segments that could be a unit in one walk so the
+    // quick match is only tried on those, the walk does not cover user
+    // defined units, case insensitive matching, bracketed units, or custom
+    // unit codes
+    UnitNameTrie::segment_set segments;
+    bool filterSegments = (match_flags & case_insensitive) == 0 &&
+        unit_string.size() <= UnitNameTrie::maxLength &&
+        unit_string.front() != '[' && unit_string.compare(0, 4, "CXUN") != 0 &&
+        unit_string.compare(0, 5, "CXCUN") != 0 &&
+        unit_string.compare(0, 5, "EQXUN") != 0;
+    if (filterSegments &&
+        allowUserDefinedUnits.load(std::memory_order_acquire)) {
+        filterSegments = !UserDefinedScope().hasUnits();
+    }
+    if (filterSegments) {
+        const auto& trie = getUnitNameTrie();
+        trie.markSegments(unit_string, false, segments);
+        trie.markSegments(unit_string, true, segments);
+    }
     std::vector<std::string> valid;
     while (part < unit_string.size() - 1) {
-        auto res = unit_quick_match(ustring, match_flags);
+        if (!takeParseStep()) {
+            return precise::invalid;
+        }
+        // ustring is only a leading segment when the sizes match
+        bool possible =
+            !filterSegments || ustring.size() != part || segments[part];
+        auto res = possible ? unit_quick_match(ustring, match_flags) :
+                              precise::invalid;
         if (!is_valid(res) && ustring.size() >= 3) {
             if (ustring.front() >= 'A' &&
                 ustring.front() <= 'Z') {  // check the lower case version
                                            // since we skipped partitioning
                                            // when we did this earlier
                 ustring[0] += 32;
-                res = unit_quick_match(ustring, match_flags);
+                if (possible) {
+                    res = unit_quick_match(ustring, match_flags);
+                }
             }
         }
         if (is_valid(res)) {
@@ -4486,12 +6788,77 @@ static precise_unit
     return precise::invalid;
 }
 
+// convert a unit string within the step budget
+static precise_unit budgetedUnitFromString(
+    std::string unit_string,
+    std::uint32_t match_flags,
+    std::uint32_t step_budget = default_step_budget)
+{
+    ParseWorkScope scope(step_budget);
+    auto retunit =
+        unit_from_string_internal(std::move(unit_string), match_flags);
+    if (scope.exhausted()) {
+        retunit = precise::invalid;
+    }
+    scope.finish(is_valid(retunit));
+    return retunit;
+}
+
+// look up a unit string in the parse cache and store the result on a miss
+static precise_unit cachedUnitFromString(
+    const char* unit_string,
+    std::size_t length,
+    std::uint32_t match_flags)
+{
+    auto hash = cacheHash(unit_string, length, match_flags);
+    precise_unit retunit;
+    if (unitParseCache().find(
+            hash,
+            [unit_string, length, match_flags](const parse_cache_key& key) {
+                return key.second == match_flags &&
+                    key.first.compare(
+                        0, std::string::npos, unit_string, length) == 0;
+            },
+            retunit)) {
+        return retunit;
+    }
+    auto generation = unitParseCache().generation();
+    std::string ustring(unit_string, length);
+    retunit = budgetedUnitFromString(ustring, match_flags);
+    unitParseCache().insert(
+        hash,
+        parse_cache_key(std::move(ustring), match_flags),
+        retunit,
+        generation);
+    return retunit;
+}
+
 precise_unit
     unit_from_string(std::string unit_string, std::uint32_t match_flags)
 {
     // always allow the code replacements on first run
     match_flags &= (~skip_code_replacements);
-    return unit_from_string_internal(std::move(unit_string), match_flags);
+    if (unitParseCache().enabled()) {
+        return cachedUnitFromString(
+            unit_string.data(), unit_string.size(), match_flags);
+    }
+    return budgetedUnitFromString(std::move(unit_string), match_flags);
+}
+
+precise_unit unit_from_chars(
+    const char* unit_string,
+    std::size_t length,
+    std::uint32_t match_flags,
+    std::uint32_t step_budget)
+{
+    match_flags &= (~skip_code_replacements);
+    // cached results were produced with the default budget
+    if (step_budget == default_step_budget && unitParseCache().enabled()) {
+        return cachedUnitFromString(unit_string, length, match_flags);
+    }
+    // strings short enough for the small string buffer do not allocate here
+    return budgetedUnitFromString(
+        std::string(unit_string, length), match_flags, step_budget);
 }
 
 // Step 1.  Check if the string matches something in the map
@@ -4517,14 +6884,22 @@ static precise_unit unit_from_string_internal(
         // than 1024 characters
         return precise::invalid;
     }
+    if (!takeParseStep()) {
+        return precise::invalid;
+    }
+    UnitDepthScope depthScope;
     precise_unit retunit;
     if ((match_flags & case_insensitive) == 0) {
         // if not a ci matching process just do a quick scan first
+        noteParsePhase(parse_phase::direct_lookup);
         retunit = get_unit(unit_string, match_flags);
         if (is_valid(retunit)) {
             return retunit;
         }
     }
+    noteParsePhase(
+        ((match_flags & case_insensitive) != 0) ? parse_phase::case_insensitive :
+                                                  parse_phase::cleaned_lookup);
     if (cleanUnitString(unit_string, match_flags)) {
         retunit = get_unit(unit_string, match_flags);
         if (is_valid(retunit)) {
@@ -4548,6 +6923,7 @@ static precise_unit unit_from_string_internal(
             partition_check1;  // only allow 3 deep for unit_partitioning
     }
     if (unit_string.front() == '{' && unit_string.back() == '}') {
+        noteParsePhase(parse_phase::commodity);
         if (unit_string.find_last_of('}', unit_string.size() - 2) ==
             std::string::npos) {
             retunit = checkForCustomUnit(unit_string);
@@ -4558,9 +6934,10 @@ static precise_unit unit_from_string_internal(
             return commoditizedUnit(unit_string, precise::one, index);
         }
     }
-    auto ustring = unit_string;
+    std::string ustring;
     // catch a preceding number on the unit
     if (looksLikeNumber(unit_string)) {
+        noteParsePhase(parse_phase::leading_number);
         if (unit_string.front() != '1' ||
             unit_string[1] != '/') {  // this catches 1/ which should be
                                       // handled differently
@@ -4627,6 +7004,7 @@ static precise_unit unit_from_string_internal(
 
     auto sep = findOperatorSep(unit_string, "*/");
     if (sep != std::string::npos) {
+        noteParsePhase(parse_phase::operator_split);
         precise_unit a_unit;
         precise_unit b_unit;
         if (sep + 1 > unit_string.size() / 2) {
@@ -4661,8 +7039,11 @@ static precise_unit unit_from_string_internal(
     bool containsPer =
         (findWordOperatorSep(unit_string, "per") != std::string::npos);
 
-    sep = findOperatorSep(unit_string, "^");
+    sep = ((characterClasses(unit_string) & caret_characters) != 0) ?
+        findOperatorSep(unit_string, "^") :
+        std::string::npos;
     if (sep != std::string::npos) {
+        noteParsePhase(parse_phase::power);
         auto pchar = sep - 1;
         if (unit_string[sep + 1] == '(') {
             ++sep;
@@ -4724,12 +7105,15 @@ static precise_unit unit_from_string_internal(
     }
     if ((match_flags & no_commodities) == 0 && unit_string.back() == '}' &&
         unit_string.find('{') != std::string::npos) {
+        noteParsePhase(parse_phase::commodity);
         return commoditizedUnit(unit_string, match_flags);
     }
+    noteParsePhase(parse_phase::si_prefix);
     retunit = checkSIprefix(unit_string, match_flags);
     if (is_valid(retunit)) {
         return retunit;
     }
+    noteParsePhase(parse_phase::modifiers);
     // don't do any further steps if recursion is not available
     if ((match_flags & no_recursion) != 0) {
         return unit_quick_match(unit_string, match_flags);
@@ -4922,11 +7306,13 @@ static precise_unit unit_from_string_internal(
             } else {
                 ustring.insert(sloc, 1, '}');
             }
+            noteParsePhase(parse_phase::commodity);
             auto cunit =
                 commoditizedUnit(ustring, match_flags + commodity_check1);
             if (is_valid(cunit)) {
                 return cunit;
             }
+            noteParsePhase(parse_phase::modifiers);
         }
     }
     // make lower case
@@ -4965,6 +7351,7 @@ static precise_unit unit_from_string_internal(
     if ((match_flags & skip_partition_check) == 0) {
         // maybe some things got merged together so lets try splitting them up
         // in various ways but only allow 3 layers deep
+        noteParsePhase(parse_phase::partitioning);
         retunit =
             tryUnitPartitioning(unit_string, match_flags + partition_check1);
         if (!is_error(retunit)) {
@@ -4974,6 +7361,53 @@ static precise_unit unit_from_string_internal(
     return precise::invalid;
 }  // namespace UNITS_NAMESPACE
 
+// convert a measurement string within the step budget
+static precise_measurement budgetedMeasurementFromString(
+    std::string measurement_string,
+    std::uint32_t match_flags,
+    std::uint32_t step_budget = default_step_budget)
+{
+    ParseWorkScope scope(step_budget);
+    auto meas = measurement_from_string_internal(
+        std::move(measurement_string), match_flags);
+    if (scope.exhausted()) {
+        meas = {constants::invalid_conversion, precise::invalid};
+    }
+    scope.finish(is_valid(meas.units()));
+    return meas;
+}
+
+// look up a measurement string in the parse cache and store the result on a
+// miss
+static precise_measurement cachedMeasurementFromString(
+    const char* measurement_string,
+    std::size_t length,
+    std::uint32_t match_flags)
+{
+    auto hash = cacheHash(measurement_string, length, match_flags);
+    precise_measurement meas;
+    if (measurementParseCache().find(
+            hash,
+            [measurement_string, length, match_flags](
+                const parse_cache_key& key) {
+                return key.second == match_flags &&
+                    key.first.compare(
+                        0, std::string::npos, measurement_string, length) == 0;
+            },
+            meas)) {
+        return meas;
+    }
+    auto generation = measurementParseCache().generation();
+    std::string mstring(measurement_string, length);
+    meas = budgetedMeasurementFromString(mstring, match_flags);
+    measurementParseCache().insert(
+        hash,
+        parse_cache_key(std::move(mstring), match_flags),
+        meas,
+        generation);
+    return meas;
+}
+
 precise_measurement measurement_from_string(
     std::string measurement_string,
     std::uint32_t match_flags)
@@ -4981,8 +7415,40 @@ precise_measurement measurement_from_string(
     if (measurement_string.empty()) {
         return {};
     }
-    // do a cleaning first to get rid of spaces and other issues
     match_flags &= (~skip_code_replacements);
+    if (measurementParseCache().enabled()) {
+        return cachedMeasurementFromString(
+            measurement_string.data(), measurement_string.size(), match_flags);
+    }
+    return budgetedMeasurementFromString(
+        std::move(measurement_string), match_flags);
+}
+
+precise_measurement measurement_from_chars(
+    const char* measurement_string,
+    std::size_t length,
+    std::uint32_t match_flags,
+    std::uint32_t step_budget)
+{
+    if (length == 0) {
+        return {};
+    }
+    match_flags &= (~skip_code_replacements);
+    // cached results were produced with the default budget
+    if (step_budget == default_step_budget &&
+        measurementParseCache().enabled()) {
+        return cachedMeasurementFromString(
+            measurement_string, length, match_flags);
+    }
+    return budgetedMeasurementFromString(
+        std::string(measurement_string, length), match_flags, step_budget);
+}
+
+static precise_measurement measurement_from_string_internal(
+    std::string measurement_string,
+    std::uint32_t match_flags)
+{
+    // do a cleaning first to get rid of spaces and other issues
     cleanUnitString(measurement_string, match_flags);
 
     size_t loc;
@@ -4998,7 +7464,14 @@ precise_measurement measurement_from_string(
         return {val, precise::one};
     }
     bool checkCurrency = (loc == 0);
-    auto ustring = measurement_string.substr(loc);
+    std::string ustring;
+    if (checkCurrency) {
+        ustring = measurement_string;
+    } else {
+        // the leading number is no longer needed so reuse the buffer
+        measurement_string.erase(0, loc);
+        ustring = std::move(measurement_string);
+    }
     auto validString = checkValidUnitString(ustring, match_flags);
     auto un = (validString) ?
         unit_from_string_internal(
@@ -5042,7 +7515,16 @@ uncertain_measurement uncertain_measurement_from_string(
     const std::string& measurement_string,
     std::uint32_t match_flags)
 {
-    if (measurement_string.empty()) {
+    return uncertain_measurement_from_chars(
+        measurement_string.data(), measurement_string.size(), match_flags);
+}
+
+uncertain_measurement uncertain_measurement_from_chars(
+    const char* measurement_string,
+    std::size_t length,
+    std::uint32_t match_flags)
+{
+    if (length == 0) {
         return {};
     }
     // first task is to find the +/-
@@ -5057,13 +7539,21 @@ uncertain_measurement uncertain_measurement_from_string(
          "&pm;",
          " \\pm "}};
 
+    const char* mend = measurement_string + length;
+    const auto classes = characterClasses(measurement_string, length);
     for (auto pmseq : pmsequences) {
-        auto loc = measurement_string.find(pmseq);
-        if (loc != std::string::npos) {
-            auto p1 = measurement_string.substr(0, loc);
-            auto m1 = measurement_cast_from_string(p1, match_flags);
-            auto p2 = measurement_string.substr(loc + strlen(pmseq));
-            auto m2 = measurement_cast_from_string(p2, match_flags);
+        auto seqlen = strlen(pmseq);
+        if ((characterClasses(pmseq, seqlen) & ~classes) != 0) {
+            // the string lacks characters required by the sequence
+            continue;
+        }
+        auto fnd = std::search(measurement_string, mend, pmseq, pmseq + seqlen);
+        if (fnd != mend) {
+            auto loc = static_cast<std::size_t>(fnd - measurement_string);
+            auto m1 = measurement_cast(
+                measurement_from_chars(measurement_string, loc, match_flags));
+            auto m2 = measurement_cast(measurement_from_chars(
+                fnd + seqlen, length - loc - seqlen, match_flags));
             if (m1.units() == one) {
                 return uncertain_measurement(
                     m1.value(), m2.value(), unit_cast(m2.units()));
@@ -5075,21 +7565,23 @@ uncertain_measurement uncertain_measurement_from_string(
         }
     }
     // check for consise form of uncertainty X.XXXXXX(UU) N
-    auto loc = measurement_string.find_first_of('(');
-    if (loc < std::string::npos && loc > 1) {
-        auto eloc = measurement_string.find_first_of(')', loc + 1);
+    auto lparen = std::find(measurement_string, mend, '(');
+    if (lparen != mend && lparen - measurement_string > 1) {
+        std::string mstring(measurement_string, length);
+        auto loc = static_cast<std::size_t>(lparen - measurement_string);
+        auto eloc = mstring.find_first_of(')', loc + 1);
         auto diff = eloc - loc;
         if (diff >= 2 && diff <= 4) {
             int cloc = static_cast<int>(loc) - 1;
             auto lc = eloc - 1;
-            char c = measurement_string[cloc];
+            char c = mstring[cloc];
             if (c >= '0' && c <= '9') {
-                auto ustring = measurement_string;
+                auto ustring = mstring;
                 while (cloc >= 0) {
-                    c = measurement_string[cloc];
+                    c = mstring[cloc];
                     if (c >= '0' && c <= '9') {
                         if (lc > loc) {
-                            ustring[cloc] = measurement_string[lc];
+                            ustring[cloc] = mstring[lc];
                             --lc;
                         } else {
                             ustring[cloc] = '0';
@@ -5097,34 +7589,278 @@ uncertain_measurement uncertain_measurement_from_string(
                     }
                     --cloc;
                 }
-                auto p = measurement_string;
-                p.erase(loc, diff + 1);
-                auto m1 = measurement_cast_from_string(p, match_flags);
+                mstring.erase(loc, diff + 1);
+                auto m1 = measurement_cast_from_string(
+                    std::move(mstring), match_flags);
                 ustring.erase(loc, diff + 1);
-                auto u1 = measurement_cast_from_string(ustring, match_flags);
+                auto u1 = measurement_cast_from_string(
+                    std::move(ustring), match_flags);
                 return uncertain_measurement(m1, u1);
             }
         }
     }
     return uncertain_measurement(
-        measurement_cast_from_string(measurement_string, match_flags), 0.0F);
+        measurement_cast(
+            measurement_from_chars(measurement_string, length, match_flags)),
+        0.0F);
 }
 
-static smap loadDefinedMeasurementTypes()
+/// joins a set of threads when it goes out of scope
+struct ThreadJoinGuard {
+    std::vector<std::thread> threads;
+    ThreadJoinGuard() = default;
+    ThreadJoinGuard(const ThreadJoinGuard&) = delete;
+    ThreadJoinGuard& operator=(const ThreadJoinGuard&) = delete;
+    ~ThreadJoinGuard()
+    {
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+};
+
+/** convert a batch of strings, each distinct string is converted once
+@param string_count the number of strings
+@param stringAt callable returning a pair of (const char*, length) for an index
+@param convert callable converting a (const char*, length) into a RESULT
+@param results the storage location for the results
+@param max_threads the maximum number of threads to use
+*/
+template<typename RESULT, typename STRINGAT, typename CONVERT>
+static void convertStringBatch(
+    std::size_t string_count,
+    STRINGAT stringAt,
+    CONVERT convert,
+    RESULT* results,
+    unsigned int max_threads)
 {
-    smap knownMeasurementTypes;
-    for (auto& pr : defined_measurement_types) {
-        if (pr.first != nullptr) {
-            knownMeasurementTypes.emplace(pr.first, pr.second);
+    if (string_count == 0) {
+        return;
+    }
+    // the map key is the index of the first occurrence of a string
+    auto hasher = [&stringAt](std::size_t index) {
+        auto str = stringAt(index);
+        return static_cast<std::size_t>(flatHash(str.first, str.second));
+    };
+    auto equal = [&stringAt](std::size_t index1, std::size_t index2) {
+        auto str1 = stringAt(index1);
+        auto str2 = stringAt(index2);
+        return str1.second == str2.second &&
+            std::equal(str1.first, str1.first + str1.second, str2.first);
+    };
+    std::unordered_map<
+        std::size_t,
+        std::size_t,
+        decltype(hasher),
+        decltype(equal)>
+        distinctIndex(string_count, hasher, equal);
+    std::vector<std::size_t> distinct;
+    std::vector<std::size_t> slot(string_count);
+    for (std::size_t ii = 0; ii < string_count; ++ii) {
+        auto res = distinctIndex.emplace(ii, distinct.size());
+        if (res.second) {
+            distinct.push_back(ii);
+        }
+        slot[ii] = res.first->second;
+    }
+
+    std::vector<RESULT> distinctResults(distinct.size());
+    std::atomic<std::size_t> next{0};
+    // the first exception thrown by a conversion, rethrown after the join
+    std::exception_ptr failure;
+    std::mutex failureLock;
+    static constexpr std::size_t chunkSize{64};
+    auto worker = [&]() {
+        try {
+            std::size_t start = next.fetch_add(chunkSize);
+            while (start < distinct.size()) {
+                auto end = (std::min)(start + chunkSize, distinct.size());
+                for (auto ii = start; ii < end; ++ii) {
+                    auto str = stringAt(distinct[ii]);
+                    distinctResults[ii] = convert(str.first, str.second);
+                }
+                start = next.fetch_add(chunkSize);
+            }
+        }
+        catch (...) {
+            // stop the other workers from taking more strings
+            next.store(distinct.size());
+            std::lock_guard<std::mutex> lock(failureLock);
+            if (!failure) {
+                failure = std::current_exception();
+            }
+        }
+    };
+
+    if (max_threads == 0) {
+        max_threads = (std::max)(std::thread::hardware_concurrency(), 1U);
+    }
+    auto threadCount = (std::min)(
+        static_cast<std::size_t>(max_threads),
+        (distinct.size() + chunkSize - 1) / chunkSize);
+    {
+        ThreadJoinGuard workers;
+        workers.threads.reserve(threadCount);
+        for (std::size_t ii = 1; ii < threadCount; ++ii) {
+            try {
+                workers.threads.emplace_back(worker);
+            }
+            catch (const std::system_error&) {
+                // the calling thread finishes the remaining strings
+                break;
+            }
         }
+        worker();
+    }
+    if (failure) {
+        std::rethrow_exception(failure);
+    }
+
+    for (std::size_t ii = 0; ii < string_count; ++ii) {
+        results[ii] = distinctResults[slot[ii]];
     }
-    return knownMeasurementTypes;
 }
 
-precise_unit default_unit(std::string unit_type)
+void units_from_strings(
+    const std::string* unit_strings,
+    std::size_t string_count,
+    precise_unit* results,
+    std::uint32_t match_flags,
+    unsigned int max_threads)
+{
+    convertStringBatch(
+        string_count,
+        [unit_strings](std::size_t index) {
+            return std::make_pair(
+                unit_strings[index].data(), unit_strings[index].size());
+        },
+        [match_flags](const char* str, std::size_t length) {
+            return unit_from_chars(str, length, match_flags);
+        },
+        results,
+        max_threads);
+}
+
+#ifdef ENABLE_UNIT_TESTING
+namespace detail {
+    namespace testing {
+        bool testBatchFailure(
+            const std::string* unit_strings,
+            std::size_t string_count,
+            std::size_t failIndex,
+            unsigned int max_threads)
+        {
+            std::vector<precise_unit> results(string_count);
+            const char* failString = unit_strings[failIndex].data();
+            try {
+                convertStringBatch(
+                    string_count,
+                    [unit_strings](std::size_t index) {
+                        return std::make_pair(
+                            unit_strings[index].data(),
+                            unit_strings[index].size());
+                    },
+                    [failString](const char* str, std::size_t length) {
+                        if (str == failString) {
+                            throw std::runtime_error("batch failure test");
+                        }
+                        return unit_from_chars(str, length, 0U);
+                    },
+                    results.data(),
+                    max_threads);
+            }
+            catch (const std::runtime_error&) {
+                return true;
+            }
+            return false;
+        }
+    }  // namespace testing
+}  // namespace detail
+#endif
+
+void units_from_strings(
+    const char* const* unit_strings,
+    const std::size_t* lengths,
+    std::size_t string_count,
+    precise_unit* results,
+    std::uint32_t match_flags,
+    unsigned int max_threads)
+{
+    convertStringBatch(
+        string_count,
+        [unit_strings, lengths](std::size_t index) {
+            return std::make_pair(unit_strings[index], lengths[index]);
+        },
+        [match_flags](const char* str, std::size_t length) {
+            return unit_from_chars(str, length, match_flags);
+        },
+        results,
+        max_threads);
+}
+
+void measurements_from_strings(
+    const std::string* measurement_strings,
+    std::size_t string_count,
+    precise_measurement* results,
+    std::uint32_t match_flags,
+    unsigned int max_threads)
+{
+    convertStringBatch(
+        string_count,
+        [measurement_strings](std::size_t index) {
+            return std::make_pair(
+                measurement_strings[index].data(),
+                measurement_strings[index].size());
+        },
+        [match_flags](const char* str, std::size_t length) {
+            return measurement_from_chars(str, length, match_flags);
+        },
+        results,
+        max_threads);
+}
+
+void measurements_from_strings(
+    const char* const* measurement_strings,
+    const std::size_t* lengths,
+    std::size_t string_count,
+    precise_measurement* results,
+    std::uint32_t match_flags,
+    unsigned int max_threads)
 {
-    static const smap measurement_types = loadDefinedMeasurementTypes();
+    convertStringBatch(
+        string_count,
+        [measurement_strings, lengths](std::size_t index) {
+            return std::make_pair(measurement_strings[index], lengths[index]);
+        },
+        [match_flags](const char* str, std::size_t length) {
+            return measurement_from_chars(str, length, match_flags);
+        },
+        results,
+        max_threads);
+}
+
+using measurementTypeIndex = FlatTableIndex<512>;
+static_assert(
+    std::tuple_size<decltype(defined_measurement_types)>::value < 512 * 3 / 4,
+    "the measurement type index needs to be enlarged");
+
+static const unitStringEntry& measurementType(std::size_t index)
+{
+    return defined_measurement_types[index];
+}
+
+static const measurementTypeIndex& getMeasurementTypeIndex()
+{
+    static const measurementTypeIndex typeIndex = []() {
+        measurementTypeIndex index;
+        indexTable(index, defined_measurement_types.size(), measurementType);
+        return index;
+    }();
+    return typeIndex;
+}
 
+precise_unit default_unit(std::string unit_type)
+{
     if (unit_type.size() == 1) {
         switch (unit_type[0]) {
             case 'L':
@@ -5147,9 +7883,14 @@ precise_unit default_unit(std::string unit_type)
         unit_type.begin(), unit_type.end(), unit_type.begin(), ::tolower);
     unit_type.erase(
         std::remove(unit_type.begin(), unit_type.end(), ' '), unit_type.end());
-    auto fnd = measurement_types.find(unit_type);
-    if (fnd != measurement_types.end()) {
-        return fnd->second;
+    auto fnd = getMeasurementTypeIndex().find(
+        flatHash(unit_type.data(), unit_type.size()),
+        [&unit_type](std::size_t ii) {
+            return keyEquals(
+                measurementType(ii).first, unit_type.data(), unit_type.size());
+        });
+    if (fnd != measurementTypeIndex::npos) {
+        return measurementType(fnd).second;
     }
     if (unit_type.compare(0, 10, "quantityof") == 0) {
         return default_unit(unit_type.substr(10));
@@ -5199,11 +7940,31 @@ precise_unit default_unit(std::string unit_type)
 namespace detail {
     const std::unordered_map<std::string, precise_unit>& getUnitStringMap()
     {
-        return base_unit_vals;
+        static const smap unitStringMap = []() {
+            smap knownUnits;
+            for (std::size_t ii = 0; ii < definedUnitStringCount; ++ii) {
+                const auto& entry = definedUnitString(ii);
+                if (entry.first != nullptr) {
+                    knownUnits.emplace(entry.first, entry.second);
+                }
+            }
+            return knownUnits;
+        }();
+        return unitStringMap;
     }
     const std::unordered_map<unit, const char*>& getUnitNameMap()
     {
-        return base_unit_names;
+        using umap = std::unordered_map<unit, const char*>;
+        static const umap unitNameMap = []() {
+            umap definedNames;
+            for (const auto& name : defined_unit_names) {
+                if (name.second != nullptr) {
+                    definedNames.emplace(name.first, name.second);
+                }
+            }
+            return definedNames;
+        }();
+        return unitNameMap;
     }
 }  // namespace detail
 #endif
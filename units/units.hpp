@@ -7,15 +7,34 @@ SPDX-License-Identifier: BSD-3-Clause
 #pragma once
 #include "unit_definitions.hpp"
 
+#include <algorithm>
+#include <array>
 #include <cmath>
+#include <cstring>
 #include <string>
+#include <system_error>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 #ifdef ENABLE_UNIT_MAP_ACCESS
 #include <unordered_map>
 #endif
 
+#if (__cplusplus >= 201703L) || (defined(_MSVC_LANG) && _MSVC_LANG >= 201703)
+#include <string_view>
+#ifndef UNITS_HAS_STRING_VIEW
+#define UNITS_HAS_STRING_VIEW
+#endif
+#endif
+
+#if (__cplusplus >= 202002L) || (defined(_MSVC_LANG) && _MSVC_LANG >= 202002L)
+#include <span>
+#if defined(__cpp_lib_span) && !defined(UNITS_HAS_SPAN)
+#define UNITS_HAS_SPAN
+#endif
+#endif
+
 #if __cplusplus >= 201402L || (defined(_MSC_VER) && _MSC_VER >= 1910)
 #define UNITS_CPP14_CONSTEXPR_OBJECT constexpr
 #define UNITS_CPP14_CONSTEXPR_METHOD constexpr
@@ -271,6 +290,317 @@ double convert(
     return convert(val, start, result * pu) * base;
 }
 
+/** A conversion between a fixed pair of units resolved once for repeated use
+@details the checks made by convert are evaluated at construction, leaving a
+single multiplication for conversions between units of the same dimension.
+Linear and affine conversions use combined factors so results can differ from
+convert in the last bit, conversions which cannot be reduced to one of the
+simple forms call convert for each value*/
+class converter {
+  public:
+    /// the form of the resolved conversion
+    enum class kind : std::uint8_t {
+        identity = 0,  //!< the value is unchanged
+        linear = 1,  //!< val*factor
+        affine = 2,  //!< val*factor+offset such as temperatures
+        inverse = 3,  //!< 1/(val*factor)
+        equation = 4,  //!< through the equation unit functions
+        general = 5,  //!< convert is called for each value
+        unconvertible = 6,  //!< the units cannot be converted
+    };
+
+    /// resolve the conversion from start to result
+    template<typename UX, typename UX2>
+    converter(const UX& start, const UX2& result) :
+        start_(start), result_(result)
+    {
+        if (start == result || is_default(start) || is_default(result)) {
+            return;
+        }
+        if ((start.has_e_flag() || result.has_e_flag()) &&
+            start.has_same_base(result.base_units())) {
+            if (resolveFlagged(start, result)) {
+                return;
+            }
+        }
+        if (start.is_equation() || result.is_equation()) {
+            if (start.base_units().equivalent_non_counting(
+                    result.base_units())) {
+                kind_ = kind::equation;
+                factor_ = start.multiplier() / result.multiplier();
+            } else {
+                kind_ = kind::unconvertible;
+            }
+            return;
+        }
+        resolveScaling(
+            convert(1.0, start, result),
+            convert(2.0, start, result),
+            start,
+            result);
+    }
+    /// resolve a conversion which may involve a per unit base value
+    template<typename UX, typename UX2>
+    converter(const UX& start, const UX2& result, double baseValue) :
+        start_(start), result_(result), base1_(baseValue), bases_(1)
+    {
+        if (start == result || is_default(start) || is_default(result)) {
+            return;
+        }
+        resolveWithBases(
+            convert(1.0, start, result, baseValue),
+            convert(2.0, start, result, baseValue),
+            start,
+            result);
+    }
+    /// resolve a conversion involving power system per unit bases
+    template<typename UX, typename UX2>
+    converter(
+        const UX& start,
+        const UX2& result,
+        double basePower,
+        double baseVoltage) :
+        start_(start),
+        result_(result), base1_(basePower), base2_(baseVoltage), bases_(2)
+    {
+        if (is_default(start) || is_default(result)) {
+            return;
+        }
+        resolveWithBases(
+            convert(1.0, start, result, basePower, baseVoltage),
+            convert(2.0, start, result, basePower, baseVoltage),
+            start,
+            result);
+    }
+
+    /// convert a single value
+    double apply(double val) const
+    {
+        switch (kind_) {
+            case kind::identity:
+                return val;
+            case kind::linear:
+                return val * factor_;
+            case kind::affine:
+                return val * factor_ + offset_;
+            case kind::inverse:
+                return 1.0 / (val * factor_);
+            case kind::equation:
+                return equationConvert(val);
+            case kind::general:
+                return generalConvert(val);
+            default:
+                return constants::invalid_conversion;
+        }
+    }
+    /// convert a single value
+    double operator()(double val) const { return apply(val); }
+
+    /** convert a sequence of values
+    @param values the values to convert
+    @param output the location for the converted values, may be the same as
+    values
+    @param elements the number of values*/
+    void apply(const double* values, double* output, std::size_t elements) const
+    {
+        switch (kind_) {
+            case kind::identity:
+                if (output != values) {
+                    std::copy(values, values + elements, output);
+                }
+                break;
+            case kind::linear:
+                for (std::size_t ii = 0; ii < elements; ++ii) {
+                    output[ii] = values[ii] * factor_;
+                }
+                break;
+            case kind::affine:
+                for (std::size_t ii = 0; ii < elements; ++ii) {
+                    output[ii] = values[ii] * factor_ + offset_;
+                }
+                break;
+            default:
+                for (std::size_t ii = 0; ii < elements; ++ii) {
+                    output[ii] = apply(values[ii]);
+                }
+                break;
+        }
+    }
+    /// convert a sequence of values in place
+    void apply(std::vector<double>& values) const
+    {
+        apply(values.data(), values.data(), values.size());
+    }
+#ifdef UNITS_HAS_SPAN
+    /// convert the values in a span in place
+    void apply(std::span<double> values) const
+    {
+        apply(values.data(), values.data(), values.size());
+    }
+    /** convert the values in one span into another
+    @details only the first min(values.size(), output.size()) are converted
+    */
+    void apply(std::span<const double> values, std::span<double> output) const
+    {
+        apply(
+            values.data(),
+            output.data(),
+            (std::min)(values.size(), output.size()));
+    }
+#endif
+
+    /// Get the form of the conversion
+    kind type() const { return kind_; }
+    /// Get the multiplication factor of a linear, affine, or inverse conversion
+    double factor() const { return factor_; }
+    /// Get the offset of an affine conversion
+    double offset() const { return offset_; }
+    /// check if the units can be converted
+    bool is_valid() const { return kind_ != kind::unconvertible; }
+
+  private:
+    /** resolve the temperature and gauge pressure conversions of
+    detail::convertFlaggedUnits
+    @return true if the conversion was resolved*/
+    template<typename UX, typename UX2>
+    bool resolveFlagged(const UX& start, const UX2& result)
+    {
+        if (is_temperature(start) || is_temperature(result)) {
+            // follow the steps of detail::convertTemperature
+            double scale{1.0};
+            double shift{0.0};
+            if (is_temperature(start)) {
+                if (units::degF == unit_cast(start)) {
+                    scale = 5.0 / 9.0;
+                    shift = -32.0 * 5.0 / 9.0;
+                } else {
+                    scale = start.multiplier();
+                }
+                shift += 273.15;
+            } else {
+                scale = start.multiplier();
+            }
+            if (is_temperature(result)) {
+                shift -= 273.15;
+                if (units::degF == unit_cast(result)) {
+                    scale *= 9.0 / 5.0;
+                    shift = shift * 9.0 / 5.0 + 32.0;
+                } else {
+                    scale /= result.multiplier();
+                    shift /= result.multiplier();
+                }
+            } else {
+                scale /= result.multiplier();
+                shift /= result.multiplier();
+            }
+            setAffine(scale, shift);
+            return true;
+        }
+        if (start.has_same_base(precise::pressure::psi.base_units())) {
+            const double scale = start.multiplier() / result.multiplier();
+            if (start.has_e_flag() == result.has_e_flag()) {
+                kind_ = kind::linear;
+                factor_ = scale;
+            } else {
+                const double atm = precise::pressure::atm.multiplier() /
+                    result.multiplier();
+                setAffine(scale, start.has_e_flag() ? atm : -atm);
+            }
+            return true;
+        }
+        return false;
+    }
+
+    void setAffine(double scale, double shift)
+    {
+        if (shift == 0.0) {
+            kind_ = (scale == 1.0) ? kind::identity : kind::linear;
+        } else {
+            kind_ = kind::affine;
+            offset_ = shift;
+        }
+        factor_ = scale;
+    }
+
+    /** classify a conversion from its results for 1 and 2
+    @details every linear conversion in convert is a product of the value and
+    some multipliers so doubling the value exactly doubles the result, and the
+    inverse conversions exactly halve it*/
+    template<typename UX, typename UX2>
+    void resolveScaling(
+        double at1,
+        double at2,
+        const UX& start,
+        const UX2& result)
+    {
+        if (std::isnan(at1)) {
+            kind_ = kind::unconvertible;
+        } else if (!std::isfinite(at1) || at1 == 0.0) {
+            kind_ = kind::general;
+        } else if (at2 == 2.0 * at1) {
+            kind_ = (at1 == 1.0) ? kind::identity : kind::linear;
+            factor_ = at1;
+        } else if (
+            at2 * 2.0 == at1 &&
+            start.base_units().has_same_base(result.base_units().inv())) {
+            kind_ = kind::inverse;
+            factor_ = start.multiplier() * result.multiplier();
+        } else {
+            kind_ = kind::general;
+        }
+    }
+
+    /// resolve the conversions taking per unit base values
+    template<typename UX, typename UX2>
+    void resolveWithBases(
+        double at1,
+        double at2,
+        const UX& start,
+        const UX2& result)
+    {
+        if (((start.has_e_flag() || result.has_e_flag()) &&
+             start.has_same_base(result.base_units())) ||
+            start.is_equation() || result.is_equation()) {
+            kind_ = kind::general;
+            return;
+        }
+        resolveScaling(at1, at2, start, result);
+        if (kind_ == kind::inverse) {
+            // the base values may have entered the conversion
+            kind_ = kind::general;
+        }
+    }
+
+    double equationConvert(double val) const
+    {
+        double keyval = precise::equations::convert_equnit_to_value(
+            val, start_.base_units());
+        return precise::equations::convert_value_to_equnit(
+            keyval * factor_, result_.base_units());
+    }
+
+    double generalConvert(double val) const
+    {
+        switch (bases_) {
+            case 0:
+                return convert(val, start_, result_);
+            case 1:
+                return convert(val, start_, result_, base1_);
+            default:
+                return convert(val, start_, result_, base1_, base2_);
+        }
+    }
+
+    kind kind_{kind::identity};
+    double factor_{1.0};
+    double offset_{0.0};
+    precise_unit start_;
+    precise_unit result_;
+    double base1_{constants::invalid_conversion};
+    double base2_{constants::invalid_conversion};
+    int bases_{0};  //!< the number of base values used by the conversion
+};
+
 /// Class defining a measurement (value+unit)
 class measurement {
   public:
@@ -1894,6 +2224,10 @@ inline std::string to_string(const unit& units, std::uint32_t match_flags = 0U)
     return to_string(precise_unit(units), match_flags);
 }
 
+/** the step_budget argument of a string conversion selecting the budget set by
+setParseStepBudget*/
+constexpr std::uint32_t default_step_budget{0xFFFFFFFFU};
+
 /** Generate a precise unit object from a string representation of it
 @param unit_string the string to convert
 @param match_flags see /ref unit_conversion_flags to control the matching
@@ -1904,6 +2238,43 @@ unit will be an error unit
 UNITS_EXPORT precise_unit
     unit_from_string(std::string unit_string, std::uint32_t match_flags = 0U);
 
+/** Generate a precise unit object from a character buffer
+@details the buffer does not need to be null terminated and is not copied
+unless the string needs to be modified during the interpretation
+@param unit_string pointer to the first character of the unit string
+@param length the number of characters in the unit string
+@param match_flags see /ref unit_conversion_flags to control the matching
+process somewhat
+@param step_budget the maximum number of interpretation steps for this call,
+0 for no limit, or default_step_budget to use the budget set through
+setParseStepBudget.  Calls with their own budget do not use the parse cache
+@return a precise unit corresponding to the string if no match was found the
+unit will be an error unit
+*/
+UNITS_EXPORT precise_unit unit_from_chars(
+    const char* unit_string,
+    std::size_t length,
+    std::uint32_t match_flags = 0U,
+    std::uint32_t step_budget = default_step_budget);
+
+#ifdef UNITS_HAS_STRING_VIEW
+/// Generate a precise unit object from a string_view
+inline precise_unit unit_from_string(
+    std::string_view unit_string,
+    std::uint32_t match_flags = 0U,
+    std::uint32_t step_budget = default_step_budget)
+{
+    return unit_from_chars(
+        unit_string.data(), unit_string.size(), match_flags, step_budget);
+}
+#endif
+/// Generate a precise unit object from a null terminated string
+inline precise_unit
+    unit_from_string(const char* unit_string, std::uint32_t match_flags = 0U)
+{
+    return unit_from_chars(unit_string, std::strlen(unit_string), match_flags);
+}
+
 /** Generate a unit object from a string representation of it
 @details uses a unit_cast to convert the precise_unit to a unit
 @param unit_string the string to convert
@@ -1937,6 +2308,46 @@ UNITS_EXPORT precise_measurement measurement_from_string(
     std::string measurement_string,
     std::uint32_t match_flags = 0U);
 
+/** Generate a precise_measurement from a character buffer
+@details the buffer does not need to be null terminated
+@param measurement_string pointer to the first character of the string
+@param length the number of characters in the string
+@param match_flags see / ref unit_conversion_flags to control the matching
+process somewhat
+@param step_budget the maximum number of interpretation steps for this call,
+0 for no limit, or default_step_budget to use the budget set through
+setParseStepBudget
+@return a precise measurement corresponding to the string
+*/
+UNITS_EXPORT precise_measurement measurement_from_chars(
+    const char* measurement_string,
+    std::size_t length,
+    std::uint32_t match_flags = 0U,
+    std::uint32_t step_budget = default_step_budget);
+
+#ifdef UNITS_HAS_STRING_VIEW
+/// Generate a precise_measurement from a string_view
+inline precise_measurement measurement_from_string(
+    std::string_view measurement_string,
+    std::uint32_t match_flags = 0U,
+    std::uint32_t step_budget = default_step_budget)
+{
+    return measurement_from_chars(
+        measurement_string.data(),
+        measurement_string.size(),
+        match_flags,
+        step_budget);
+}
+#endif
+/// Generate a precise_measurement from a null terminated string
+inline precise_measurement measurement_from_string(
+    const char* measurement_string,
+    std::uint32_t match_flags = 0U)
+{
+    return measurement_from_chars(
+        measurement_string, std::strlen(measurement_string), match_flags);
+}
+
 /** Generate a measurement from a string
 @param measurement_string the string to convert
 @param match_flags see / ref unit_conversion_flags to control the matching
@@ -1966,6 +2377,187 @@ UNITS_EXPORT uncertain_measurement uncertain_measurement_from_string(
     const std::string& measurement_string,
     std::uint32_t match_flags = 0U);
 
+/** Generate an uncertain_measurement from a character buffer
+@details the buffer does not need to be null terminated
+@param measurement_string pointer to the first character of the string
+@param length the number of characters in the string
+@param match_flags see /ref unit_conversion_flags to control the matching
+process somewhat
+*/
+UNITS_EXPORT uncertain_measurement uncertain_measurement_from_chars(
+    const char* measurement_string,
+    std::size_t length,
+    std::uint32_t match_flags = 0U);
+
+#ifdef UNITS_HAS_STRING_VIEW
+/// Generate an uncertain_measurement from a string_view
+inline uncertain_measurement uncertain_measurement_from_string(
+    std::string_view measurement_string,
+    std::uint32_t match_flags = 0U)
+{
+    return uncertain_measurement_from_chars(
+        measurement_string.data(), measurement_string.size(), match_flags);
+}
+#endif
+/// Generate an uncertain_measurement from a null terminated string
+inline uncertain_measurement uncertain_measurement_from_string(
+    const char* measurement_string,
+    std::uint32_t match_flags = 0U)
+{
+    return uncertain_measurement_from_chars(
+        measurement_string, std::strlen(measurement_string), match_flags);
+}
+
+/** Generate precise units from a sequence of strings
+@details identical strings are only interpreted once and the distinct strings
+are divided among a set of worker threads
+@param unit_strings pointer to the first of string_count strings
+@param string_count the number of strings
+@param results pointer to storage for string_count units
+@param match_flags see /ref unit_conversion_flags to control the matching
+process somewhat
+@param max_threads the maximum number of threads to use, 0 to use the hardware
+concurrency of the system
+*/
+UNITS_EXPORT void units_from_strings(
+    const std::string* unit_strings,
+    std::size_t string_count,
+    precise_unit* results,
+    std::uint32_t match_flags = 0U,
+    unsigned int max_threads = 1U);
+
+/** Generate precise units from a sequence of character buffers
+@param unit_strings pointer to the first of string_count character buffers
+@param lengths pointer to the lengths of each of the buffers
+@param string_count the number of strings
+@param results pointer to storage for string_count units
+@param match_flags see /ref unit_conversion_flags
+@param max_threads the maximum number of threads to use, 0 to use the hardware
+concurrency of the system
+*/
+UNITS_EXPORT void units_from_strings(
+    const char* const* unit_strings,
+    const std::size_t* lengths,
+    std::size_t string_count,
+    precise_unit* results,
+    std::uint32_t match_flags = 0U,
+    unsigned int max_threads = 1U);
+
+/// Generate a vector of precise units from a vector of strings
+inline std::vector<precise_unit> units_from_strings(
+    const std::vector<std::string>& unit_strings,
+    std::uint32_t match_flags = 0U,
+    unsigned int max_threads = 1U)
+{
+    std::vector<precise_unit> results(unit_strings.size());
+    units_from_strings(
+        unit_strings.data(),
+        unit_strings.size(),
+        results.data(),
+        match_flags,
+        max_threads);
+    return results;
+}
+
+/** Generate precise measurements from a sequence of strings
+@details identical strings are only interpreted once and the distinct strings
+are divided among a set of worker threads
+@param measurement_strings pointer to the first of string_count strings
+@param string_count the number of strings
+@param results pointer to storage for string_count measurements
+@param match_flags see /ref unit_conversion_flags
+@param max_threads the maximum number of threads to use, 0 to use the hardware
+concurrency of the system
+*/
+UNITS_EXPORT void measurements_from_strings(
+    const std::string* measurement_strings,
+    std::size_t string_count,
+    precise_measurement* results,
+    std::uint32_t match_flags = 0U,
+    unsigned int max_threads = 1U);
+
+/** Generate precise measurements from a sequence of character buffers
+@param measurement_strings pointer to the first of string_count character
+buffers
+@param lengths pointer to the lengths of each of the buffers
+@param string_count the number of strings
+@param results pointer to storage for string_count measurements
+@param match_flags see /ref unit_conversion_flags
+@param max_threads the maximum number of threads to use, 0 to use the hardware
+concurrency of the system
+*/
+UNITS_EXPORT void measurements_from_strings(
+    const char* const* measurement_strings,
+    const std::size_t* lengths,
+    std::size_t string_count,
+    precise_measurement* results,
+    std::uint32_t match_flags = 0U,
+    unsigned int max_threads = 1U);
+
+/// Generate a vector of precise measurements from a vector of strings
+inline std::vector<precise_measurement> measurements_from_strings(
+    const std::vector<std::string>& measurement_strings,
+    std::uint32_t match_flags = 0U,
+    unsigned int max_threads = 1U)
+{
+    std::vector<precise_measurement> results(measurement_strings.size());
+    measurements_from_strings(
+        measurement_strings.data(),
+        measurement_strings.size(),
+        results.data(),
+        match_flags,
+        max_threads);
+    return results;
+}
+
+#ifdef UNITS_HAS_STRING_VIEW
+/// Generate a vector of precise units from a vector of string_views
+inline std::vector<precise_unit> units_from_strings(
+    const std::vector<std::string_view>& unit_strings,
+    std::uint32_t match_flags = 0U,
+    unsigned int max_threads = 1U)
+{
+    std::vector<const char*> buffers(unit_strings.size());
+    std::vector<std::size_t> lengths(unit_strings.size());
+    for (std::size_t ii = 0; ii < unit_strings.size(); ++ii) {
+        buffers[ii] = unit_strings[ii].data();
+        lengths[ii] = unit_strings[ii].size();
+    }
+    std::vector<precise_unit> results(unit_strings.size());
+    units_from_strings(
+        buffers.data(),
+        lengths.data(),
+        unit_strings.size(),
+        results.data(),
+        match_flags,
+        max_threads);
+    return results;
+}
+
+/// Generate a vector of precise measurements from a vector of string_views
+inline std::vector<precise_measurement> measurements_from_strings(
+    const std::vector<std::string_view>& measurement_strings,
+    std::uint32_t match_flags = 0U,
+    unsigned int max_threads = 1U)
+{
+    std::vector<const char*> buffers(measurement_strings.size());
+    std::vector<std::size_t> lengths(measurement_strings.size());
+    for (std::size_t ii = 0; ii < measurement_strings.size(); ++ii) {
+        buffers[ii] = measurement_strings[ii].data();
+        lengths[ii] = measurement_strings[ii].size();
+    }
+    std::vector<precise_measurement> results(measurement_strings.size());
+    measurements_from_strings(
+        buffers.data(),
+        lengths.data(),
+        measurement_strings.size(),
+        results.data(),
+        match_flags,
+        max_threads);
+    return results;
+}
+#endif
+
 /// Convert a precise measurement to a string (with some extra decimal digits
 /// displayed)
 UNITS_EXPORT std::string to_string(
@@ -1981,6 +2573,117 @@ UNITS_EXPORT std::string to_string(
     const uncertain_measurement& measure,
     std::uint32_t match_flags = 0U);
 
+/// The result of writing a unit or measurement into a character buffer
+struct to_chars_result {
+    char* ptr;  //!< one past the last character written
+    std::errc ec;  //!< std::errc() or std::errc::value_too_large
+};
+
+/** Write the string representation of a unit into a character buffer
+@details the output is the same as to_string, the characters are not null
+terminated.  If the to_string cache is enabled and contains the unit no heap
+allocation is made
+@return the end of the written characters, if the buffer is too small the ptr
+is last and ec is std::errc::value_too_large*/
+UNITS_EXPORT to_chars_result to_chars(
+    char* first,
+    char* last,
+    const precise_unit& units,
+    std::uint32_t match_flags = 0U);
+
+/// Write the string representation of a unit into a character buffer
+inline to_chars_result to_chars(
+    char* first,
+    char* last,
+    const unit& units,
+    std::uint32_t match_flags = 0U)
+{
+    return to_chars(first, last, precise_unit(units), match_flags);
+}
+
+/** Write a measurement into a character buffer
+@details the value is written with the fewest digits which convert back to
+the same value independent of the current locale, followed by a space and
+the unit as written by to_chars
+@return the end of the written characters, if the buffer is too small the ptr
+is last and ec is std::errc::value_too_large*/
+UNITS_EXPORT to_chars_result to_chars(
+    char* first,
+    char* last,
+    const precise_measurement& measure,
+    std::uint32_t match_flags = 0U);
+
+/// Write a measurement into a character buffer
+inline to_chars_result to_chars(
+    char* first,
+    char* last,
+    const measurement& measure,
+    std::uint32_t match_flags = 0U)
+{
+    return to_chars(
+        first,
+        last,
+        precise_measurement(measure.value(), precise_unit(measure.units())),
+        match_flags);
+}
+
+/// The layout of the records written by measurements_to_string
+enum class record_format : std::uint8_t {
+    delimited = 0,  //!< value and unit fields with a delimiter such as CSV
+    ndjson = 1,  //!< lines of {"value":<value>,"unit":"<unit>"}
+};
+
+/** Write a sequence of measurements as records into a single buffer
+@details each record is terminated by a newline, values are written with the
+fewest digits which convert back to the same value and each distinct unit is
+converted to a string only once.  Delimited unit fields are quoted if needed,
+in ndjson infinite and nan values are written as null
+@param measurements pointer to the first of measurement_count measurements
+@param measurement_count the number of measurements
+@param output the string to append the records to
+@param format the layout of the records
+@param delimiter the field separator for record_format::delimited
+@param match_flags see /ref unit_conversion_flags
+*/
+UNITS_EXPORT void measurements_to_string(
+    const precise_measurement* measurements,
+    std::size_t measurement_count,
+    std::string& output,
+    record_format format = record_format::delimited,
+    char delimiter = ',',
+    std::uint32_t match_flags = 0U);
+
+/** Write a sequence of values sharing a single unit as records into a buffer
+@details the records are the same as measurements_to_string with each value
+paired with units, the unit is converted to a string once
+*/
+UNITS_EXPORT void measurements_to_string(
+    const double* values,
+    std::size_t value_count,
+    const precise_unit& units,
+    std::string& output,
+    record_format format = record_format::delimited,
+    char delimiter = ',',
+    std::uint32_t match_flags = 0U);
+
+/// Write a vector of measurements as records into a string
+inline std::string measurements_to_string(
+    const std::vector<precise_measurement>& measurements,
+    record_format format = record_format::delimited,
+    char delimiter = ',',
+    std::uint32_t match_flags = 0U)
+{
+    std::string output;
+    measurements_to_string(
+        measurements.data(),
+        measurements.size(),
+        output,
+        format,
+        delimiter,
+        match_flags);
+    return output;
+}
+
 /// Add a custom unit to be included in any string processing
 UNITS_EXPORT void
     addUserDefinedUnit(const std::string& name, const precise_unit& un);
@@ -2011,6 +2714,113 @@ UNITS_EXPORT void disableUserDefinedUnits();
 /// Enable the ability to add custom units for later access
 UNITS_EXPORT void enableUserDefinedUnits();
 
+/// Usage counters for one of the string processing caches
+struct cache_statistics {
+    std::uint64_t hits{0};  //!< number of lookups answered from the cache
+    std::uint64_t misses{0};  //!< number of lookups that had to be computed
+    std::size_t entries{0};  //!< number of results currently stored
+    std::size_t capacity{0};  //!< maximum number of stored results
+};
+
+/** enable caching of the results of unit_from_string and
+measurement_from_string
+@details results are keyed on the string and match_flags, the cache is safe
+to use from multiple threads and is invalidated whenever user defined units,
+custom commodities, or the units domain are modified
+@param maxEntries the maximum number of results to store for each of the two
+functions
+*/
+UNITS_EXPORT void enableParseCache(std::size_t maxEntries = 4096);
+/// Turn off the parse cache and release any stored results
+UNITS_EXPORT void disableParseCache();
+/// Remove all stored results from the parse cache
+UNITS_EXPORT void clearParseCache();
+/// Get the combined usage counters of the parse cache
+UNITS_EXPORT cache_statistics getParseCacheStatistics();
+
+/** enable caching of the strings generated by to_string for units
+@details results are keyed on the exact unit and match_flags, the cache is
+safe to use from multiple threads and is invalidated whenever user defined
+units, custom commodities, or the units domain are modified
+@param maxEntries the maximum number of strings to store
+*/
+UNITS_EXPORT void enableToStringCache(std::size_t maxEntries = 1024);
+/// Turn off the to_string cache and release any stored strings
+UNITS_EXPORT void disableToStringCache();
+/// Remove all stored strings from the to_string cache
+UNITS_EXPORT void clearToStringCache();
+/// Get the usage counters of the to_string cache
+UNITS_EXPORT cache_statistics getToStringCacheStatistics();
+
+/** set the default limit on the work a single unit_from_string or
+measurement_from_string call can do
+@details each interpretation attempt counts as a step, the count is
+deterministic for a given string and match_flags so a string exceeding the
+budget always produces an invalid unit (and a measurement with an invalid
+value and unit).  This budget applies to every thread; a conversion of a
+character buffer or string_view can pass its own budget instead, which leaves
+the default and the parse cache untouched
+@param maxSteps the maximum number of steps for a single conversion, 0 removes
+the limit which is the default
+@return the previous budget
+*/
+UNITS_EXPORT std::uint32_t setParseStepBudget(std::uint32_t maxSteps);
+/// Get the current step budget for a single string conversion
+UNITS_EXPORT std::uint32_t getParseStepBudget();
+/// Get the number of string conversions stopped by the step budget
+UNITS_EXPORT std::uint64_t getParseBudgetExhaustedCount();
+
+/// The stage of the string interpretation which resolved a unit string
+enum class parse_phase : std::uint8_t {
+    direct_lookup = 0,  //!< found in the unit tables as given
+    cleaned_lookup = 1,  //!< found after cleaning up the string
+    case_insensitive = 2,  //!< found after a case insensitive conversion
+    commodity = 3,  //!< resolved through commodity handling
+    leading_number = 4,  //!< resolved after splitting off a leading number
+    operator_split = 5,  //!< resolved by splitting on '*' or '/'
+    power = 6,  //!< resolved as a unit raised to a power
+    si_prefix = 7,  //!< resolved as an SI prefix on a unit
+    modifiers = 8,  //!< resolved through word modifiers and other rewrites
+    partitioning = 9,  //!< resolved by splitting apart merged unit names
+};
+
+/// the number of values in parse_phase
+constexpr std::size_t parse_phase_count{10};
+
+/** counters collected from unit_from_string and measurement_from_string
+while parse instrumentation is enabled*/
+struct parse_statistics {
+    std::uint64_t conversions{0};  //!< number of string conversions
+    std::uint64_t failures{0};  //!< conversions producing an invalid unit
+    /// successful conversions indexed by the parse_phase resolving them
+    std::array<std::uint64_t, parse_phase_count> resolutions{};
+    /// the number of string segments copied for recursive interpretation
+    std::uint64_t string_copies{0};
+    /// the sum over all conversions of the maximum recursion depth reached
+    std::uint64_t total_recursion_depth{0};
+    std::uint32_t max_recursion_depth{0};  //!< deepest recursion seen
+    /** sampled conversion times, bucket i counts times in
+    [2^i, 2^(i+1)) nanoseconds with bucket 0 also holding times below 1ns*/
+    std::array<std::uint64_t, 32> latency_histogram{};
+    std::uint64_t latency_samples{0};  //!< number of timed conversions
+};
+
+/** turn on collection of statistics about unit and measurement string
+interpretation
+@details the statistics are intended for tuning input normalization, when
+disabled (the default) the collection is skipped entirely
+@param latencySampleInterval time every Nth conversion on each thread and
+record it in the latency histogram, 0 disables timing
+*/
+UNITS_EXPORT void
+    enableParseInstrumentation(std::uint32_t latencySampleInterval = 0);
+/// Turn off the collection of parse statistics, the counters are retained
+UNITS_EXPORT void disableParseInstrumentation();
+/// Set all the parse statistics counters back to 0
+UNITS_EXPORT void resetParseStatistics();
+/// Get a copy of the parse statistics counters
+UNITS_EXPORT parse_statistics getParseStatistics();
+
 /// get the code to use for a particular commodity
 UNITS_EXPORT std::uint32_t getCommodity(std::string comm);
 
@@ -2026,15 +2836,256 @@ UNITS_EXPORT void disableCustomCommodities();
 /// Enable the ability to add custom commodities for later access
 UNITS_EXPORT void enableCustomCommodities();
 
+/// Identifier of a unit stored in the unit registry
+using unit_id = std::uint16_t;
+/// The unit_id used for units which are not or could not be registered
+constexpr unit_id invalid_unit_id{0xFFFFU};
+
+/** get the id of a unit in the unit registry, adding it if not present
+@details units are matched exactly including the bits of the multiplier and
+the commodity, ids are assigned in order and remain valid for the life of the
+process, lookups never block
+@return the id of the unit, or invalid_unit_id if the registry already holds
+the maximum of 65535 units
+*/
+UNITS_EXPORT unit_id internUnit(const precise_unit& un);
+/// Get the id of a unit in the unit registry or invalid_unit_id if not present
+UNITS_EXPORT unit_id getUnitId(const precise_unit& un);
+/// Get the unit for an id from the unit registry, precise::invalid if unknown
+UNITS_EXPORT precise_unit getInternedUnit(unit_id id);
+/// Get the number of units in the unit registry
+UNITS_EXPORT std::size_t getInternedUnitCount();
+
+/** A measurement storing its unit as an id from the unit registry
+@details the value is stored without alignment requirements so the object
+occupies 10 bytes and measurements with the same unit can be compared
+through the ids without looking at the units*/
+class interned_measurement {
+  public:
+    /// construct with a value of 0 and invalid_unit_id
+    interned_measurement() noexcept : interned_measurement(0.0, invalid_unit_id)
+    {
+    }
+    /// construct from a value and the id of a registered unit
+    interned_measurement(double val, unit_id id) noexcept : id_(id)
+    {
+        std::memcpy(value_, &val, sizeof(double));
+    }
+    /// construct from a value and a unit, adding the unit to the registry
+    interned_measurement(double val, const precise_unit& base) :
+        interned_measurement(val, internUnit(base))
+    {
+    }
+    /// construct from a precise_measurement, adding the unit to the registry
+    explicit interned_measurement(const precise_measurement& meas) :
+        interned_measurement(meas.value(), meas.units())
+    {
+    }
+
+    /// Get the numerical value of the measurement
+    double value() const noexcept
+    {
+        double val;
+        std::memcpy(&val, value_, sizeof(double));
+        return val;
+    }
+    /// Get the id of the unit
+    unit_id id() const noexcept { return id_; }
+    /// Get the unit from the registry
+    precise_unit units() const { return getInternedUnit(id_); }
+    /// Get the value of the measurement in a different unit
+    double value_as(const precise_unit& desired_units) const
+    {
+        return convert(value(), units(), desired_units);
+    }
+    /// convert to a precise_measurement
+    // NOLINTNEXTLINE(google-explicit-constructor)
+    operator precise_measurement() const { return {value(), units()}; }
+
+    /// check if the units of two measurements are the same
+    bool has_same_unit(const interned_measurement& other) const noexcept
+    {
+        return id_ == other.id_;
+    }
+    /// Equality operator, only measurements with different ids access the units
+    bool operator==(const interned_measurement& other) const
+    {
+        return (id_ == other.id_) ?
+            precise_measurement(value(), precise::one) ==
+                precise_measurement(other.value(), precise::one) :
+            precise_measurement(*this) == precise_measurement(other);
+    }
+    /// Not equal operator
+    bool operator!=(const interned_measurement& other) const
+    {
+        return !operator==(other);
+    }
+
+  private:
+    char value_[sizeof(double)];  //!< the unaligned bits of the value
+    unit_id id_;  //!< the id of the unit in the registry
+};
+
+/** Convert an array of values from one unit to another
+@details the conversion is resolved once and linear, affine, and inverse
+conversions are applied with vectorized kernels selected for the processor,
+the results are identical to calling convert on each value with the same units
+@param values the values to convert
+@param output the location for the converted values, may be the same as values
+@param elements the number of values
+*/
+UNITS_EXPORT void convert(
+    const double* values,
+    double* output,
+    std::size_t elements,
+    const precise_unit& start,
+    const precise_unit& result);
+/** Convert an array of float values from one unit to another
+@details the values are converted as doubles, giving the results of converting
+each value with convert and rounding to float
+*/
+UNITS_EXPORT void convert(
+    const float* values,
+    float* output,
+    std::size_t elements,
+    const precise_unit& start,
+    const precise_unit& result);
+
+#ifdef UNITS_HAS_SPAN
+/// Convert the values of one span into another, up to the smaller size
+inline void convert(
+    std::span<const double> values,
+    std::span<double> output,
+    const precise_unit& start,
+    const precise_unit& result)
+{
+    convert(
+        values.data(),
+        output.data(),
+        (std::min)(values.size(), output.size()),
+        start,
+        result);
+}
+/// Convert the values in a span in place
+inline void convert(
+    std::span<double> values,
+    const precise_unit& start,
+    const precise_unit& result)
+{
+    convert(values.data(), values.data(), values.size(), start, result);
+}
+/// Convert the float values of one span into another, up to the smaller size
+inline void convert(
+    std::span<const float> values,
+    std::span<float> output,
+    const precise_unit& start,
+    const precise_unit& result)
+{
+    convert(
+        values.data(),
+        output.data(),
+        (std::min)(values.size(), output.size()),
+        start,
+        result);
+}
+/// Convert the float values in a span in place
+inline void convert(
+    std::span<float> values,
+    const precise_unit& start,
+    const precise_unit& result)
+{
+    convert(values.data(), values.data(), values.size(), start, result);
+}
+#endif
+
+namespace precise {
+    namespace equations {
+        /// The accuracy of the array conversions of equation units
+        enum class eq_accuracy : std::uint8_t {
+            strict = 0,  //!< identical to converting each value
+            fast = 1,  //!< vectorized exp and log approximations
+        };
+
+        /** convert an array of equation unit values to values
+        @details with eq_accuracy::fast the logarithmic units use vectorized
+        approximations with a relative error below 2e-16*(2+|log2(result)|),
+        results below 2^-1021 are flushed to zero, the other equation units
+        use the scalar conversion
+        @param output the location for the converted values, may be the same
+        as values*/
+        UNITS_EXPORT void convert_equnit_to_value(
+            const double* values,
+            double* output,
+            std::size_t elements,
+            const detail::unit_data& UT,
+            eq_accuracy accuracy = eq_accuracy::strict);
+
+        /** convert an array of values to equation unit values
+        @details with eq_accuracy::fast the logarithmic units use vectorized
+        approximations with an absolute error below 6e-16 times the larger of
+        1 and the magnitude of the scaled logarithm before any offset, the
+        other equation units use the scalar conversion
+        @param output the location for the converted values, may be the same
+        as values*/
+        UNITS_EXPORT void convert_value_to_equnit(
+            const double* values,
+            double* output,
+            std::size_t elements,
+            const detail::unit_data& UT,
+            eq_accuracy accuracy = eq_accuracy::strict);
+    }  // namespace equations
+}  // namespace precise
+
 #define EXTRA_UNIT_STANDARDS
 // Some specific unit code standards
 #ifdef EXTRA_UNIT_STANDARDS
 /// generate a unit from a string as defined by the X12 standard
 UNITS_EXPORT precise_unit x12_unit(const std::string& x12_string);
+/// generate a unit from a character buffer as defined by the X12 standard
+UNITS_EXPORT precise_unit x12_unit(const char* x12_string, std::size_t length);
 /// generate a unit from a string as defined by the US DOD
 UNITS_EXPORT precise_unit dod_unit(const std::string& dod_string);
+/// generate a unit from a character buffer as defined by the US DOD
+UNITS_EXPORT precise_unit dod_unit(const char* dod_string, std::size_t length);
 /// generate a unit from a string as defined by the r20 standard
 UNITS_EXPORT precise_unit r20_unit(const std::string& r20_string);
+/// generate a unit from a character buffer as defined by the r20 standard
+UNITS_EXPORT precise_unit r20_unit(const char* r20_string, std::size_t length);
+
+#ifdef UNITS_HAS_STRING_VIEW
+/// generate a unit from a string_view as defined by the X12 standard
+inline precise_unit x12_unit(std::string_view x12_string)
+{
+    return x12_unit(x12_string.data(), x12_string.size());
+}
+/// generate a unit from a null terminated string as defined by the X12
+/// standard
+inline precise_unit x12_unit(const char* x12_string)
+{
+    return x12_unit(x12_string, std::strlen(x12_string));
+}
+/// generate a unit from a string_view as defined by the US DOD
+inline precise_unit dod_unit(std::string_view dod_string)
+{
+    return dod_unit(dod_string.data(), dod_string.size());
+}
+/// generate a unit from a null terminated string as defined by the US DOD
+inline precise_unit dod_unit(const char* dod_string)
+{
+    return dod_unit(dod_string, std::strlen(dod_string));
+}
+/// generate a unit from a string_view as defined by the r20 standard
+inline precise_unit r20_unit(std::string_view r20_string)
+{
+    return r20_unit(r20_string.data(), r20_string.size());
+}
+/// generate a unit from a null terminated string as defined by the r20
+/// standard
+inline precise_unit r20_unit(const char* r20_string)
+{
+    return r20_unit(r20_string, std::strlen(r20_string));
+}
+#endif
 #endif
 
 #endif  // UNITS_HEADER_ONLY
@@ -2171,12 +3222,34 @@ namespace detail {
         std::string
             testCleanUpString(std::string testString, std::uint32_t commodity);
 
+        // test the input string normalization used before unit lookup
+        std::string
+            testCleanUnitString(std::string testString, std::uint32_t flags);
+
         // test the add unit power operations
         void testAddUnitPower(
             std::string& str,
             const char* unit,
             int power,
             std::uint32_t flags);
+
+        // run a batch conversion of distinct strings in which the string at
+        // failIndex throws, true if the exception reached the caller
+        bool testBatchFailure(
+            const std::string* unit_strings,
+            std::size_t string_count,
+            std::size_t failIndex,
+            unsigned int max_threads);
+
+        // run a bulk conversion with a specific kernel (0 scalar, 1 SSE2,
+        // 2 AVX2, 3 AVX-512), false if unavailable or not a kernel conversion
+        bool testBulkKernel(
+            int kernel,
+            const double* values,
+            double* output,
+            std::size_t elements,
+            const precise_unit& start,
+            const precise_unit& result);
     }  // namespace testing
 }  // namespace detail
 #endif
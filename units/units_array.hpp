@@ -0,0 +1,571 @@
+/*
+Copyright (c) 2019-2022,
+Lawrence Livermore National Security, LLC;
+See the top-level NOTICE for additional details. All rights reserved.
+SPDX-License-Identifier: BSD-3-Clause
+*/
+#pragma once
+
+#include "units.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace UNITS_NAMESPACE {
+namespace detail {
+    /** check if a conversion between units with different multipliers is
+    performed by convert as `val * start.multiplier() / result.multiplier()`
+    */
+    template<class UX, class UX2>
+    bool is_scaled_conversion(const UX& start, const UX2& result)
+    {
+        if (start.has_e_flag() || result.has_e_flag() || start.is_equation() ||
+            result.is_equation()) {
+            return false;
+        }
+        if (start.base_units() == result.base_units()) {
+            return true;
+        }
+        return !start.is_per_unit() && !result.is_per_unit() &&
+            start.base_units().has_same_base(result.base_units());
+    }
+
+    /** combine each value in `a` with the corresponding value of `b`
+    converted from `start` to `result`, the conversion is checked once and
+    done with the same arithmetic as convert so the results match the scalar
+    operations exactly*/
+    template<class UX, class UX2, class Op>
+    void combine_converted(
+        const double* a,
+        const double* b,
+        double* out,
+        std::size_t elements,
+        const UX& start,
+        const UX2& result,
+        Op op)
+    {
+        if (start == result || is_default(start) || is_default(result)) {
+            for (std::size_t ii = 0; ii < elements; ++ii) {
+                out[ii] = op(a[ii], b[ii]);
+            }
+        } else if (is_scaled_conversion(start, result)) {
+            const double smult = start.multiplier();
+            const double rmult = result.multiplier();
+            for (std::size_t ii = 0; ii < elements; ++ii) {
+                out[ii] = op(a[ii], b[ii] * smult / rmult);
+            }
+        } else {
+            for (std::size_t ii = 0; ii < elements; ++ii) {
+                out[ii] = op(a[ii], convert(b[ii], start, result));
+            }
+        }
+    }
+
+    /// operation for combine_converted returning the converted value
+    struct second_value {
+        double operator()(double /*unused*/, double val) const { return val; }
+    };
+}  // namespace detail
+
+/** A sequence of values sharing a single unit
+@details the values are stored contiguously, the operations adjust the unit
+once and then operate on the values in a single loop with the same results as
+the corresponding operations on individual measurements*/
+template<class UX>
+class basic_measurement_array {
+  public:
+    static_assert(
+        std::is_same<UX, unit>::value || std::is_same<UX, precise_unit>::value,
+        "the unit type must be unit or precise_unit");
+    /// the type of the individual measurements
+    using measurement_type = typename std::conditional<
+        std::is_same<UX, precise_unit>::value,
+        precise_measurement,
+        measurement>::type;
+    using iterator = std::vector<double>::iterator;
+    using const_iterator = std::vector<double>::const_iterator;
+
+    /// Default constructor, an empty array with a unit of one
+    basic_measurement_array() = default;
+    /// construct an empty array with a unit
+    explicit basic_measurement_array(const UX& base) : units_(base) {}
+    /// construct from a set of values and a unit
+    basic_measurement_array(std::vector<double> vals, const UX& base) :
+        values_(std::move(vals)), units_(base)
+    {
+    }
+    /// construct from a list of values and a unit
+    basic_measurement_array(
+        std::initializer_list<double> vals,
+        const UX& base) :
+        values_(vals),
+        units_(base)
+    {
+    }
+    /// construct with a number of copies of a value
+    basic_measurement_array(std::size_t elements, double val, const UX& base) :
+        values_(elements, val), units_(base)
+    {
+    }
+
+    /// Get the number of values
+    std::size_t size() const { return values_.size(); }
+    /// check if there are no values
+    bool empty() const { return values_.empty(); }
+    /// Get the unit shared by all the values
+    UX units() const { return units_; }
+    /// Get the values
+    const std::vector<double>& values() const { return values_; }
+    double* data() { return values_.data(); }
+    const double* data() const { return values_.data(); }
+    double& operator[](std::size_t index) { return values_[index]; }
+    double operator[](std::size_t index) const { return values_[index]; }
+    /// Get the measurement at an index
+    measurement_type measurement_at(std::size_t index) const
+    {
+        return {values_[index], units_};
+    }
+    iterator begin() { return values_.begin(); }
+    iterator end() { return values_.end(); }
+    const_iterator begin() const { return values_.begin(); }
+    const_iterator end() const { return values_.end(); }
+
+    /// add a value in the unit of the array
+    void push_back(double val) { values_.push_back(val); }
+    /// add a measurement converting it to the unit of the array
+    void push_back(const measurement_type& meas)
+    {
+        values_.push_back(meas.value_as(units_));
+    }
+    void reserve(std::size_t elements) { values_.reserve(elements); }
+    void resize(std::size_t elements) { values_.resize(elements); }
+    void clear() { values_.clear(); }
+
+    /// Get the values converted to another unit
+    template<class UX2>
+    std::vector<double> value_as(const UX2& desired_units) const
+    {
+        std::vector<double> result(values_.size());
+        detail::combine_converted(
+            values_.data(),
+            values_.data(),
+            result.data(),
+            values_.size(),
+            units_,
+            desired_units,
+            detail::second_value());
+        return result;
+    }
+    /// Convert the values to a new unit
+    basic_measurement_array convert_to(const UX& newUnits) const
+    {
+        return {value_as(newUnits), newUnits};
+    }
+
+    basic_measurement_array operator*(double val) const
+    {
+        basic_measurement_array result(*this);
+        result *= val;
+        return result;
+    }
+    basic_measurement_array operator/(double val) const
+    {
+        basic_measurement_array result(*this);
+        result /= val;
+        return result;
+    }
+    basic_measurement_array& operator*=(double val)
+    {
+        for (auto& value : values_) {
+            value *= val;
+        }
+        return *this;
+    }
+    basic_measurement_array& operator/=(double val)
+    {
+        for (auto& value : values_) {
+            value /= val;
+        }
+        return *this;
+    }
+    friend basic_measurement_array
+        operator*(double val, const basic_measurement_array& arr)
+    {
+        return arr * val;
+    }
+    friend basic_measurement_array
+        operator/(double val, const basic_measurement_array& arr)
+    {
+        basic_measurement_array result(arr.units_.inv());
+        result.values_.resize(arr.size());
+        for (std::size_t ii = 0; ii < arr.size(); ++ii) {
+            result.values_[ii] = val / arr.values_[ii];
+        }
+        return result;
+    }
+
+    basic_measurement_array operator*(const UX& other) const
+    {
+        return {values_, units_ * other};
+    }
+    basic_measurement_array operator/(const UX& other) const
+    {
+        return {values_, units_ / other};
+    }
+
+    basic_measurement_array operator*(const measurement_type& other) const
+    {
+        basic_measurement_array result(*this * other.value());
+        result.units_ = units_ * other.units();
+        return result;
+    }
+    basic_measurement_array operator/(const measurement_type& other) const
+    {
+        basic_measurement_array result(*this / other.value());
+        result.units_ = units_ / other.units();
+        return result;
+    }
+    /// add a measurement to each value
+    basic_measurement_array operator+(const measurement_type& other) const
+    {
+        basic_measurement_array result(*this);
+        result += other;
+        return result;
+    }
+    /// subtract a measurement from each value
+    basic_measurement_array operator-(const measurement_type& other) const
+    {
+        basic_measurement_array result(*this);
+        result -= other;
+        return result;
+    }
+    basic_measurement_array& operator+=(const measurement_type& other)
+    {
+        const double val = other.value_as(units_);
+        for (auto& value : values_) {
+            value += val;
+        }
+        return *this;
+    }
+    basic_measurement_array& operator-=(const measurement_type& other)
+    {
+        const double val = other.value_as(units_);
+        for (auto& value : values_) {
+            value -= val;
+        }
+        return *this;
+    }
+
+    /** multiply the values of two arrays
+    @details arrays of different sizes produce an empty array with an error
+    unit*/
+    basic_measurement_array
+        operator*(const basic_measurement_array& other) const
+    {
+        if (other.size() != size()) {
+            return basic_measurement_array(UX(precise::error.base_units()));
+        }
+        basic_measurement_array result(units_ * other.units_);
+        result.values_.resize(size());
+        for (std::size_t ii = 0; ii < size(); ++ii) {
+            result.values_[ii] = values_[ii] * other.values_[ii];
+        }
+        return result;
+    }
+    /** divide the values of two arrays
+    @details arrays of different sizes produce an empty array with an error
+    unit*/
+    basic_measurement_array
+        operator/(const basic_measurement_array& other) const
+    {
+        if (other.size() != size()) {
+            return basic_measurement_array(UX(precise::error.base_units()));
+        }
+        basic_measurement_array result(units_ / other.units_);
+        result.values_.resize(size());
+        for (std::size_t ii = 0; ii < size(); ++ii) {
+            result.values_[ii] = values_[ii] / other.values_[ii];
+        }
+        return result;
+    }
+    /** add the values of another array converted to the unit of this array
+    @details arrays of different sizes produce an empty array with an error
+    unit*/
+    basic_measurement_array
+        operator+(const basic_measurement_array& other) const
+    {
+        return combine(other, std::plus<double>());
+    }
+    /** subtract the values of another array converted to the unit of this
+    array
+    @details arrays of different sizes produce an empty array with an error
+    unit*/
+    basic_measurement_array
+        operator-(const basic_measurement_array& other) const
+    {
+        return combine(other, std::minus<double>());
+    }
+
+    /// check if the arrays have the same unit and the same values
+    bool operator==(const basic_measurement_array& other) const
+    {
+        return units_ == other.units_ && values_ == other.values_;
+    }
+    bool operator!=(const basic_measurement_array& other) const
+    {
+        return !operator==(other);
+    }
+
+  private:
+    template<class Op>
+    basic_measurement_array
+        combine(const basic_measurement_array& other, Op op) const
+    {
+        if (other.size() != size()) {
+            return basic_measurement_array(UX(precise::error.base_units()));
+        }
+        basic_measurement_array result(units_);
+        result.values_.resize(size());
+        detail::combine_converted(
+            values_.data(),
+            other.values_.data(),
+            result.values_.data(),
+            size(),
+            other.units_,
+            units_,
+            op);
+        return result;
+    }
+
+    std::vector<double> values_;  //!< the values in the shared unit
+    UX units_;  //!< the unit of all the values
+};
+
+/// A sequence of values sharing a single unit
+using measurement_array = basic_measurement_array<unit>;
+/// A sequence of values sharing a single precise_unit
+using precise_measurement_array = basic_measurement_array<precise_unit>;
+
+/** A sequence of measurements stored as values and an index into a table of
+the distinct units
+@details conversions of the whole column are computed once for each distinct
+unit instead of once for each value*/
+class precise_measurement_column {
+  public:
+    /// the type of the index of the unit of each row
+    using index_type = std::uint16_t;
+
+    /// the values of a column with a common dimension
+    struct dimension_group {
+        /// the values converted to the base unit of the dimension
+        precise_measurement_array values;
+        /// the row of the column each value came from
+        std::vector<std::size_t> rows;
+    };
+
+    /// Default constructor, an empty column
+    precise_measurement_column() = default;
+    /// construct from a sequence of measurements
+    explicit precise_measurement_column(
+        const std::vector<precise_measurement>& measurements)
+    {
+        reserve(measurements.size());
+        for (const auto& meas : measurements) {
+            push_back(meas);
+        }
+    }
+
+    /** add a row to the column
+    @return false if the unit would exceed the maximum of 65536 distinct units
+    in which case the row is not added*/
+    bool push_back(double val, const precise_unit& base)
+    {
+        auto index = unitIndex(base);
+        if (index == dictionary_.size()) {
+            if (dictionary_.size() > std::numeric_limits<index_type>::max()) {
+                return false;
+            }
+            dictionary_.push_back(base);
+        }
+        last_ = index;
+        values_.push_back(val);
+        indices_.push_back(static_cast<index_type>(index));
+        return true;
+    }
+    /// add a measurement to the column
+    bool push_back(const precise_measurement& meas)
+    {
+        return push_back(meas.value(), meas.units());
+    }
+    void reserve(std::size_t rows)
+    {
+        values_.reserve(rows);
+        indices_.reserve(rows);
+    }
+    void clear()
+    {
+        values_.clear();
+        indices_.clear();
+        dictionary_.clear();
+        last_ = 0;
+    }
+
+    /// Get the number of rows
+    std::size_t size() const { return values_.size(); }
+    /// check if there are no rows
+    bool empty() const { return values_.empty(); }
+    /// Get the values of each row in the unit of the row
+    const std::vector<double>& values() const { return values_; }
+    /// Get the index into the dictionary of the unit of each row
+    const std::vector<index_type>& unit_indices() const { return indices_; }
+    /// Get the distinct units in the column in order of first appearance
+    const std::vector<precise_unit>& dictionary() const { return dictionary_; }
+    /// Get the unit of a row
+    precise_unit units(std::size_t row) const
+    {
+        return dictionary_[indices_[row]];
+    }
+    /// Get the measurement in a row
+    precise_measurement measurement_at(std::size_t row) const
+    {
+        return {values_[row], units(row)};
+    }
+
+    /** Get the values of all the rows converted to a single unit
+    @details the results match precise_measurement::value_as for each row*/
+    std::vector<double> value_as(const precise_unit& desired_units) const
+    {
+        std::vector<double> result(values_.size());
+        convertRows(
+            std::vector<precise_unit>(dictionary_.size(), desired_units),
+            result.data());
+        return result;
+    }
+    /// Convert all the rows to a single unit
+    precise_measurement_array convert_to(const precise_unit& newUnits) const
+    {
+        return {value_as(newUnits), newUnits};
+    }
+
+    /** split the rows into groups of convertible units
+    @details units are grouped on their base units ignoring the flags, and the
+    values in each group are converted to the base units of the group, groups
+    are in order of first appearance*/
+    std::vector<dimension_group> group_by_dimension() const
+    {
+        std::vector<dimension_group> groups;
+        std::vector<std::size_t> entryGroup(dictionary_.size());
+        std::vector<precise_unit> targets(dictionary_.size());
+        for (std::size_t ii = 0; ii < dictionary_.size(); ++ii) {
+            auto base = dictionary_[ii].base_units();
+            base.clear_flags();
+            std::size_t group = 0;
+            while (group < groups.size() &&
+                   groups[group].values.units().base_units() != base) {
+                ++group;
+            }
+            if (group == groups.size()) {
+                groups.push_back(
+                    {precise_measurement_array(precise_unit(base)), {}});
+            }
+            entryGroup[ii] = group;
+            targets[ii] = groups[group].values.units();
+        }
+        std::vector<double> converted(values_.size());
+        convertRows(targets, converted.data());
+        for (std::size_t row = 0; row < values_.size(); ++row) {
+            auto& group = groups[entryGroup[indices_[row]]];
+            group.values.push_back(converted[row]);
+            group.rows.push_back(row);
+        }
+        return groups;
+    }
+
+    /// Get the rows as a sequence of measurements
+    std::vector<precise_measurement> to_measurements() const
+    {
+        std::vector<precise_measurement> result;
+        result.reserve(values_.size());
+        for (std::size_t row = 0; row < values_.size(); ++row) {
+            result.emplace_back(values_[row], dictionary_[indices_[row]]);
+        }
+        return result;
+    }
+
+  private:
+    /// check if a unit matches a dictionary entry including NaN multipliers
+    static bool sameUnit(const precise_unit& entry, const precise_unit& un)
+    {
+        return entry.base_units() == un.base_units() &&
+            entry.commodity() == un.commodity() &&
+            (entry.multiplier() == un.multiplier() ||
+             (std::isnan(entry.multiplier()) && std::isnan(un.multiplier())));
+    }
+    /// find the dictionary index of a unit, dictionary_.size() if not present
+    std::size_t unitIndex(const precise_unit& un) const
+    {
+        // rows frequently repeat the unit of the previous row
+        if (last_ < dictionary_.size() && sameUnit(dictionary_[last_], un)) {
+            return last_;
+        }
+        std::size_t index = 0;
+        while (index < dictionary_.size() &&
+               !sameUnit(dictionary_[index], un)) {
+            ++index;
+        }
+        return index;
+    }
+
+    /** convert the rows of each dictionary entry to the matching target unit
+    @details each entry whose conversion is a plain scaling gets a pair of
+    multipliers applied to its rows in a single loop with the same arithmetic
+    as convert, the rows of any other entries are converted individually
+    afterwards*/
+    void convertRows(const std::vector<precise_unit>& targets, double* out)
+        const
+    {
+        std::vector<double> smult(dictionary_.size(), 1.0);
+        std::vector<double> rmult(dictionary_.size(), 1.0);
+        std::vector<char> general(dictionary_.size(), 0);
+        bool anyGeneral{false};
+        for (std::size_t ii = 0; ii < dictionary_.size(); ++ii) {
+            const auto& start = dictionary_[ii];
+            const auto& result = targets[ii];
+            if (start == result || is_default(start) || is_default(result)) {
+                continue;
+            }
+            if (detail::is_scaled_conversion(start, result)) {
+                smult[ii] = start.multiplier();
+                rmult[ii] = result.multiplier();
+            } else {
+                general[ii] = 1;
+                anyGeneral = true;
+            }
+        }
+        for (std::size_t row = 0; row < values_.size(); ++row) {
+            const auto index = indices_[row];
+            out[row] = values_[row] * smult[index] / rmult[index];
+        }
+        if (anyGeneral) {
+            for (std::size_t row = 0; row < values_.size(); ++row) {
+                const auto index = indices_[row];
+                if (general[index] != 0) {
+                    out[row] = convert(
+                        values_[row], dictionary_[index], targets[index]);
+                }
+            }
+        }
+    }
+
+    std::vector<double> values_;  //!< the value of each row
+    std::vector<index_type> indices_;  //!< the unit index of each row
+    std::vector<precise_unit> dictionary_;  //!< the distinct units
+    std::size_t last_{0};  //!< the index of the most recently added unit
+};
+
+}  // namespace UNITS_NAMESPACE
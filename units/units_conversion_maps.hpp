@@ -97,8 +97,8 @@ UNITS_CPP14_CONSTEXPR_OBJECT std::array<std::pair<unit, const char*>, 180>
          {deg, "deg"},
          {rad, "rad"},
          {unit_cast(precise::angle::grad), "grad"},
-         {degC, u8"\u00B0C"},
-         {degF, u8"\u00B0F"},
+         {degC, "\xC2\xB0" "C"},
+         {degF, "\xC2\xB0" "F"},
          {mile, "mi"},
          {mile * mile, "mi^2"},
          {unit_cast(precise::mile.pow(2)), "mi^2"},
@@ -185,7 +185,7 @@ UNITS_CPP14_CONSTEXPR_OBJECT std::array<std::pair<unit, const char*>, 180>
          {unit_cast(precise::us::dry::bushel), "bu"},
          {unit_cast(precise::us::floz), "floz"},
          {oz, "oz"},
-         {unit_cast(precise::distance::angstrom), u8"\u00C5"},
+         {unit_cast(precise::distance::angstrom), "\xC3\x85"},
          {g, "g"},
          {mg, "mg"},
          {unit_cast(precise::us::cup), "cup"},
@@ -232,8 +232,8 @@ UNITS_CPP14_CONSTEXPR_OBJECT std::array<
         {"-infinity", precise::neginfinite},
         {"-INFINITY", precise::neginfinite},
         {"infinite", precise::infinite},
-        {u8"\u221e", precise::infinite},
-        {u8"-\u221e", precise::neginfinite},
+        {"\xE2\x88\x9E", precise::infinite},
+        {"-\xE2\x88\x9E", precise::neginfinite},
         {"nan", precise::nan},
         {"NaN", precise::nan},
         {"NaN%", precise::nan},
@@ -315,10 +315,10 @@ UNITS_CPP14_CONSTEXPR_OBJECT std::array<
         {"percent", precise::percent},
         {"percentage", precise::percent},
         {"permille", precise::milli},
-        {u8"\u2030", precise::milli},  // per mille symbol
+        {"\xE2\x80\xB0", precise::milli},  // per mille symbol
         {"bp", precise_unit(0.1, precise::milli)},
         {"basispoint", precise_unit(0.1, precise::milli)},
-        {u8"\u2031",
+        {"\xE2\x80\xB1",
          precise_unit(0.1, precise::milli)},  // per ten thousand symbol
         {"pct", precise::percent},
         {"pi", precise_unit(constants::pi, one)},
@@ -327,10 +327,10 @@ UNITS_CPP14_CONSTEXPR_OBJECT std::array<
         {"thenumberpi", precise_unit(constants::pi, one)},
         {"[PI]", precise_unit(constants::pi, one)},
         {"Pi", precise_unit(constants::pi, one)},
-        {u8"\u03C0", precise_unit(constants::pi, one)},
-        {u8"\U0001D70B", precise_unit(constants::pi, one)},
-        {u8"\U0001D745", precise_unit(constants::pi, one)},
-        {u8"\U0001D6D1", precise_unit(constants::pi, one)},
+        {"\xCF\x80", precise_unit(constants::pi, one)},
+        {"\xF0\x9D\x9C\x8B", precise_unit(constants::pi, one)},
+        {"\xF0\x9D\x9D\x85", precise_unit(constants::pi, one)},
+        {"\xF0\x9D\x9B\x91", precise_unit(constants::pi, one)},
         {"m", precise::m},
         {"Sm", precise::m},  // standard meter used in oil and gas usually Sm^3
         {"meter", precise::m},
@@ -464,8 +464,8 @@ UNITS_CPP14_CONSTEXPR_OBJECT std::array<
         {"Ohm", precise::ohm},
         {"kilohm", precise::kilo* precise::ohm},  // special case allowed by SI
         {"megohm", precise::mega* precise::ohm},  // special case allowed by SI
-        {u8"\u03A9", precise::ohm},  // Greek Omega
-        {u8"\u2126", precise::ohm},  // Unicode Ohm symbol
+        {"\xCE\xA9", precise::ohm},  // Greek Omega
+        {"\xE2\x84\xA6", precise::ohm},  // Unicode Ohm symbol
         {"abOhm", precise::cgs::abOhm},
         {"abohm", precise::cgs::abOhm},
         {"statohm", precise::cgs::statOhm},
@@ -478,7 +478,7 @@ UNITS_CPP14_CONSTEXPR_OBJECT std::array<
         {"gemmho", precise_unit(1e-6, precise::S)},
         {"MHO", precise::S},
         {"mHO", precise::S},
-        {u8"\u01B1", precise::S},
+        {"\xC6\xB1", precise::S},
         {"absiemen", precise_unit(1e9, precise::S)},
         {"abmho", precise_unit(1e9, precise::S)},
         {"statmho", precise_unit(1.0 / 8.987551787e11, S)},
@@ -660,9 +660,9 @@ UNITS_CPP14_CONSTEXPR_OBJECT std::array<
         {"degT", precise::deg* precise::direction::north},
         {"true", precise::direction::north},
         {"o", precise::deg},
-        {u8"\u00B0", precise::deg},  // unicode degree symbol
+        {"\xC2\xB0", precise::deg},  // unicode degree symbol
         {"\xB0", precise::deg},  // latin-1 degree
-        {u8"\u00B0(s)", precise::deg},  // unicode degree symbol
+        {"\xC2\xB0(s)", precise::deg},  // unicode degree symbol
         {"\xB0(s)", precise::deg},  // latin-1 degree
         {"arcminute", precise::angle::arcmin},
         {"arcmin", precise::angle::arcmin},
@@ -671,7 +671,7 @@ UNITS_CPP14_CONSTEXPR_OBJECT std::array<
         {"angularminute", precise::angle::arcmin},
         {"'", precise::angle::arcmin},
         {"`", precise::angle::arcmin},
-        {u8"\u2032", precise::angle::arcmin},  // single prime
+        {"\xE2\x80\xB2", precise::angle::arcmin},  // single prime
         {"arcsecond", precise::angle::arcsec},
         {"''", precise::angle::arcsec},
         {"``", precise::angle::arcsec},
@@ -679,7 +679,7 @@ UNITS_CPP14_CONSTEXPR_OBJECT std::array<
         {"asec", precise::angle::arcsec},
         {"angularsecond", precise::angle::arcsec},
         {"\"", precise::angle::arcsec},
-        {u8"\u2033", precise::angle::arcsec},  // double prime
+        {"\xE2\x80\xB3", precise::angle::arcsec},  // double prime
         {"mas", precise_unit(0.001, precise::angle::arcsec)},  // milliarcsec
         {"uas", precise_unit(0.000001, precise::angle::arcsec)},  // microarcsec
         {"rad", precise::rad},
@@ -701,12 +701,12 @@ UNITS_CPP14_CONSTEXPR_OBJECT std::array<
         {"\xB0"
          "C",
          precise::degC},
-        {u8"\u00B0C", precise::degC},
-        {u8"\u2103", precise::degC},  // direct unicode symbol
+        {"\xC2\xB0" "C", precise::degC},
+        {"\xE2\x84\x83", precise::degC},  // direct unicode symbol
         {"\xB0"
          "K",
          precise::K},
-        {u8"\u00B0K", precise::K},
+        {"\xC2\xB0K", precise::K},
 
         {"degC", precise::degC},
         {"oC", precise::degC},
@@ -742,8 +742,8 @@ UNITS_CPP14_CONSTEXPR_OBJECT std::array<
         {"[hbar]", constants::hbar.as_unit()},
         {"hbar", constants::hbar.as_unit()},
         {"[H]", constants::h.as_unit()},
-        {u8"\u210E", constants::h.as_unit()},
-        {u8"\u210F",
+        {"\xE2\x84\x8E", constants::h.as_unit()},
+        {"\xE2\x84\x8F",
          precise_unit(1.0 / constants::tau, constants::h.as_unit())},
         {"[k]", constants::k.as_unit()},
         {"[K]", constants::k.as_unit()},
@@ -751,10 +751,10 @@ UNITS_CPP14_CONSTEXPR_OBJECT std::array<
         {"[eps_0]", constants::eps0.as_unit()},
         {"vacuumpermittivity", constants::eps0.as_unit()},
         {"[EPS_0]", constants::eps0.as_unit()},
-        {u8"\u03B5"
+        {"\xCE\xB5"
          "0",
          constants::eps0.as_unit()},
-        {u8"\u03B5\u2080", constants::eps0.as_unit()},
+        {"\xCE\xB5\xE2\x82\x80", constants::eps0.as_unit()},
         {"mu_0", constants::mu0.as_unit()},
         {"[MU_0]", constants::mu0.as_unit()},
         {"[mu0]", constants::mu0.as_unit()},
@@ -825,15 +825,15 @@ UNITS_CPP14_CONSTEXPR_OBJECT std::array<
         {"yen", precise::currency},
         {"ruble", precise::currency},
         {"currency", precise::currency},
-        {u8"\u00A2", precise_unit(0.01, precise::currency)},  // cent symbol
+        {"\xC2\xA2", precise_unit(0.01, precise::currency)},  // cent symbol
         {"\xA2", precise_unit(0.01, precise::currency)},  // cent symbol latin-1
-        {u8"\u00A3", precise::currency},  // pound sign
+        {"\xC2\xA3", precise::currency},  // pound sign
         {"\xA3", precise::currency},  // pound sign latin-1
-        {u8"\u00A4", precise::currency},  // currency sign
+        {"\xC2\xA4", precise::currency},  // currency sign
         {"\xA4", precise::currency},  // currency sign latin-1
-        {u8"\u00A5", precise::currency},  // Yen sign
+        {"\xC2\xA5", precise::currency},  // Yen sign
         {"\xA5", precise::currency},  // Yen sign latin-1
-        {u8"\u0080", precise::currency},  // Euro sign
+        {"\xC2\x80", precise::currency},  // Euro sign
         {"\x80", precise::currency},  // Euro sign extended ascii
         {"count", precise::count},
         {"unit", precise::count},
@@ -925,9 +925,9 @@ UNITS_CPP14_CONSTEXPR_OBJECT std::array<
         {"roentgen", precise::cgs::roentgen},
         {"r\xF6ntgen", precise::cgs::roentgen},
         {"parker", precise::cgs::roentgen},
-        {u8"r\u00f6ntgen", precise::cgs::roentgen},
-        {u8"ro\u0308ntgen", precise::cgs::roentgen},
-        {u8"ro\u00A8ntgen", precise::cgs::roentgen},
+        {"r\xC3\xB6ntgen", precise::cgs::roentgen},
+        {"ro\xCC\x88ntgen", precise::cgs::roentgen},
+        {"ro\xC2\xA8ntgen", precise::cgs::roentgen},
         {"Roe", precise::cgs::roentgen},
         {"ROE", precise::cgs::roentgen},
         {"R", precise::cgs::roentgen},
@@ -1123,15 +1123,15 @@ UNITS_CPP14_CONSTEXPR_OBJECT std::array<
         {"atomicmassunit", precise::mass::u},
 
         {"angstrom", precise::distance::angstrom},
-        {u8"\u00C5ngstr\u00F6m", precise::distance::angstrom},
+        {"\xC3\x85ngstr\xC3\xB6m", precise::distance::angstrom},
         {"\xE5ngstr\xF6m", precise::distance::angstrom},
-        {u8"\u00E5ngstr\u00F6m", precise::distance::angstrom},
+        {"\xC3\xA5ngstr\xC3\xB6m", precise::distance::angstrom},
         {"Ao", precise::distance::angstrom},
         {"AO", precise::distance::angstrom},
-        {u8"\u00C5", precise::distance::angstrom},
-        {u8"A\u02DA", precise::distance::angstrom},
+        {"\xC3\x85", precise::distance::angstrom},
+        {"A\xCB\x9A", precise::distance::angstrom},
         {"\xC5", precise::distance::angstrom},
-        {u8"\u212B", precise::distance::angstrom},  // unicode
+        {"\xE2\x84\xAB", precise::distance::angstrom},  // unicode
         {"bps", precise::bit / precise::s},
         {"baud", precise::bit / precise::s},
         {"Bd", precise::bit / precise::s},
@@ -1164,7 +1164,7 @@ UNITS_CPP14_CONSTEXPR_OBJECT std::array<
         {"g", precise::g},
         {"gm", precise::g},
         {"gamma", precise::micro* precise::g},
-        {u8"\u1D6FE", precise::micro* precise::g},
+        {"\xE1\xB5\xAF" "E", precise::micro* precise::g},
         {"gamma{mass}", precise::micro* precise::g},
         {"gamma(mass)", precise::micro* precise::g},
         {"gamma{volume}", precise::micro* precise::L},
@@ -1672,7 +1672,7 @@ UNITS_CPP14_CONSTEXPR_OBJECT std::array<
         {"gon", precise::angle::gon},
         {"gon(grade)", precise::angle::gon},
         {"GON", precise::angle::gon},
-        {u8"\u25A1^g", precise::angle::gon},
+        {"\xE2\x96\xA1^g", precise::angle::gon},
         {"^g", precise::angle::gon},
         {"grad", precise::angle::grad},
         {"gradians", precise::angle::grad},
@@ -1682,26 +1682,26 @@ UNITS_CPP14_CONSTEXPR_OBJECT std::array<
         {"degF", precise::degF},
         {"degsF", precise::degF},
         {"[DEGF]", precise::degF},
-        {u8"\u2109", precise::degF},  // direct unicode symbol
+        {"\xE2\x84\x89", precise::degF},  // direct unicode symbol
         {"degR", precise::temperature::degR},
         {"degsR", precise::temperature::degR},
         {"[DEGR]", precise::temperature::degR},
-        {u8"\u00B0R", precise::temperature::degR},
-        {u8"\u00B0r", precise::temperature::reaumur},
+        {"\xC2\xB0R", precise::temperature::degR},
+        {"\xC2\xB0r", precise::temperature::reaumur},
         {"\xB0R", precise::temperature::degR},
         {"\xB0r", precise::temperature::reaumur},
         {"[DEGRE]", precise::temperature::reaumur},
         {"degRe", precise::temperature::reaumur},
         {"degsRe", precise::temperature::reaumur},
-        {u8"degR\u00e9aumur", precise::temperature::reaumur},
-        {u8"\u00B0R\u00e9", precise::temperature::reaumur},
-        {u8"\u00B0Re", precise::temperature::reaumur},
-        {u8"\u00B0Ra", precise::temperature::degR},
+        {"degR\xC3\xA9" "aumur", precise::temperature::reaumur},
+        {"\xC2\xB0R\xC3\xA9", precise::temperature::reaumur},
+        {"\xC2\xB0Re", precise::temperature::reaumur},
+        {"\xC2\xB0Ra", precise::temperature::degR},
         {"\xB0Re", precise::temperature::reaumur},
         {"\xB0Ra", precise::temperature::degR},
         {"degReaumur", precise::temperature::reaumur},
         {"reaumur", precise::temperature::reaumur},
-        {u8"r\u00e9aumur", precise::temperature::reaumur},
+        {"r\xC3\xA9" "aumur", precise::temperature::reaumur},
         {"degFahrenheit", precise::degF},
         {"degRankine", precise::temperature::degR},
         {"degrankine", precise::temperature::degR},
@@ -1712,7 +1712,7 @@ UNITS_CPP14_CONSTEXPR_OBJECT std::array<
         {"\xB0"
          "F",
          precise::degF},
-        {u8"\u00b0F", precise::degF},
+        {"\xC2\xB0" "F", precise::degF},
         {"fahrenheit", precise::degF},
         {"mi", precise::mile},
         {"mi_i", precise::mile},
@@ -1852,20 +1852,20 @@ UNITS_CPP14_CONSTEXPR_OBJECT std::array<
         {"kilogramcalories", precise::energy::kcal},
         {"calorie(nutritional)", precise::energy::cal_it},
         {"cal_[15]", precise::energy::cal_15},
-        {u8"cal_15\u00B0C", precise::energy::cal_15},
-        {u8"calorieat15\u00B0C", precise::energy::cal_15},
+        {"cal_15\xC2\xB0" "C", precise::energy::cal_15},
+        {"calorieat15\xC2\xB0" "C", precise::energy::cal_15},
         {"caloriesat15C", precise::energy::cal_15},
         {"calories15C", precise::energy::cal_15},
         {"calorie15C", precise::energy::cal_15},
         {"cal_[20]", precise::energy::cal_20},
-        {u8"calorieat20\u00B0C", precise::energy::cal_20},
+        {"calorieat20\xC2\xB0" "C", precise::energy::cal_20},
         {"caloriesat20C", precise::energy::cal_20},
         {"calorie20C", precise::energy::cal_20},
         {"cals20C", precise::energy::cal_20},
         {"cal20C", precise::energy::cal_20},
         {"cals15C", precise::energy::cal_15},
         {"cal15C", precise::energy::cal_15},
-        {u8"cal_20\u00B0C", precise::energy::cal_20},
+        {"cal_20\xC2\xB0" "C", precise::energy::cal_20},
         {"CAL_[15]", precise::energy::cal_15},
         {"CAL_[20]", precise::energy::cal_20},
         {"cal_m", precise::energy::cal_mean},
@@ -1897,18 +1897,18 @@ UNITS_CPP14_CONSTEXPR_OBJECT std::array<
         {"Btu_39", precise::energy::btu_39},
         {"BTU_39", precise::energy::btu_39},
         {"BTU39F", precise::energy::btu_39},
-        {u8"BTU39\u00B0F", precise::energy::btu_39},
-        {u8"btu_39\u00B0F", precise::energy::btu_39},
+        {"BTU39\xC2\xB0" "F", precise::energy::btu_39},
+        {"btu_39\xC2\xB0" "F", precise::energy::btu_39},
         {"Btu_59", precise::energy::btu_59},
         {"BTU_59", precise::energy::btu_59},
         {"BTU59F", precise::energy::btu_59},
-        {u8"BTU59\u00B0F", precise::energy::btu_59},
-        {u8"btu_59\u00B0F", precise::energy::btu_59},
+        {"BTU59\xC2\xB0" "F", precise::energy::btu_59},
+        {"btu_59\xC2\xB0" "F", precise::energy::btu_59},
         {"Btu_60", precise::energy::btu_60},
         {"BTU_60", precise::energy::btu_60},
         {"BTU60F", precise::energy::btu_60},
-        {u8"BTU60\u00B0F", precise::energy::btu_60},
-        {u8"btu_60\u00B0F", precise::energy::btu_60},
+        {"BTU60\xC2\xB0" "F", precise::energy::btu_60},
+        {"btu_60\xC2\xB0" "F", precise::energy::btu_60},
         {"Btu_m", precise::energy::btu_mean},
         {"BTU_m", precise::energy::btu_mean},
         {"BTU_M", precise::energy::btu_mean},
@@ -1934,8 +1934,9 @@ UNITS_CPP14_CONSTEXPR_OBJECT std::array<
 
         {"C90", precise::conventional::coulomb90},
         {"ohm90", precise::conventional::ohm90},
-        {u8"\u03A990", precise::conventional::ohm90},  // Greek Omega
-        {u8"\u212690", precise::conventional::ohm90},  // Unicode Ohm symbol
+        {"\xCE\xA9" "90", precise::conventional::ohm90},  // Greek Omega
+        {"\xE2\x84\xA6" "90",
+         precise::conventional::ohm90},  // Unicode Ohm symbol
         {"A90", precise::conventional::ampere90},
         {"V90", precise::conventional::volt90},
         {"W90", precise::conventional::watt90},
@@ -1943,8 +1944,9 @@ UNITS_CPP14_CONSTEXPR_OBJECT std::array<
         {"H90", precise::conventional::henry90},
         {"C_90", precise::conventional::coulomb90},
         {"ohm_90", precise::conventional::ohm90},
-        {u8"\u03A9_90", precise::conventional::ohm90},  // Greek Omega
-        {u8"\u2126_90", precise::conventional::ohm90},  // Unicode Ohm symbol
+        {"\xCE\xA9_90", precise::conventional::ohm90},  // Greek Omega
+        {"\xE2\x84\xA6_90",
+         precise::conventional::ohm90},  // Unicode Ohm symbol
         {"A_90", precise::conventional::ampere90},
         {"V_90", precise::conventional::volt90},
         {"W_90", precise::conventional::watt90},
@@ -2135,7 +2137,7 @@ UNITS_CPP14_CONSTEXPR_OBJECT std::array<
         {"liquidoz", precise::us::floz},
         {"oz", precise::oz},
         {"OZ", precise::oz},
-        {u8"\u2125", precise::oz},
+        {"\xE2\x84\xA5", precise::oz},
         {"gr", precise::i::grain},
         {"[GR]", precise::i::grain},
         {"grain", precise::i::grain},
@@ -2211,9 +2213,9 @@ UNITS_CPP14_CONSTEXPR_OBJECT std::array<
         {"[SC_AP]", precise::apothecaries::scruple},
         {"scruple", precise::apothecaries::scruple},
         {"scruple_ap", precise::apothecaries::scruple},
-        {u8"\u2108", precise::apothecaries::scruple},
+        {"\xE2\x84\x88", precise::apothecaries::scruple},
         {"dr_ap", precise::apothecaries::drachm},
-        {u8"\u0292", precise::apothecaries::drachm},
+        {"\xCA\x92", precise::apothecaries::drachm},
         {"dram_ap", precise::apothecaries::drachm},
         {"[DR_AP]", precise::apothecaries::drachm},
         {"oz_ap", precise::apothecaries::ounce},
@@ -2491,10 +2493,10 @@ std::array<std::pair<const char*, precise_unit>, 236> defined_measurement_types{
         {"electriccurrent", precise::A},
         {"magnetomotiveforce", precise::A},
         {"temperature", precise::K},
-        {u8"\u2C90", precise::K},
-        {u8"\u2129", precise::K},
-        {u8"\u03F4", precise::K},
-        {u8"\u0398", precise::K},
+        {"\xE2\xB2\x90", precise::K},
+        {"\xE2\x84\xA9", precise::K},
+        {"\xCF\xB4", precise::K},
+        {"\xCE\x98", precise::K},
         {"celsiustemperature", precise::degC},
         {"temp", precise::K},
         {"thermodynamictemperature", precise::K},
@@ -0,0 +1,328 @@
+/*
+Copyright (c) 2019-2022,
+Lawrence Livermore National Security, LLC;
+See the top-level NOTICE for additional details. All rights reserved.
+SPDX-License-Identifier: BSD-3-Clause
+*/
+#pragma once
+
+/** @file
+conversion of unit strings to precise_units at compile time, the
+UNITS_UNIT_LITERAL macro requires C++14 relaxed constexpr and the _unit
+literal requires C++20 consteval
+*/
+
+#if __cplusplus >= 201402L || (defined(_MSC_VER) && _MSC_VER >= 1910)
+
+#include "units_conversion_maps.hpp"
+
+#include <cstddef>
+
+#if defined(__cpp_consteval) && __cpp_consteval >= 201811L
+#ifndef UNITS_HAS_UNIT_LITERALS
+#define UNITS_HAS_UNIT_LITERALS
+#endif
+#endif
+
+namespace UNITS_NAMESPACE {
+namespace detail {
+    /** the failure path of the unit literal parser, it is deliberately not
+    constexpr so a string which cannot be parsed is a compile error when the
+    literal is evaluated at compile time*/
+    inline precise_unit unitLiteralNotRecognized() { return precise::error; }
+
+    /// the SI prefix multiplier for a character, 0 if it is not a prefix
+    constexpr double literalPrefixMultiplier(char prefix)
+    {
+        switch (prefix) {
+            case 'y':
+                return 1e-24;
+            case 'z':
+                return 1e-21;
+            case 'a':
+                return 1e-18;
+            case 'f':
+                return 1e-15;
+            case 'p':
+                return 1e-12;
+            case 'n':
+                return 1e-9;
+            case 'u':
+                return 1e-6;
+            case 'm':
+                return 1e-3;
+            case 'c':
+                return 1e-2;
+            case 'd':
+                return 1e-1;
+            case 'h':
+                return 1e2;
+            case 'k':
+                return 1e3;
+            case 'M':
+                return 1e6;
+            case 'G':
+                return 1e9;
+            case 'T':
+                return 1e12;
+            case 'P':
+                return 1e15;
+            case 'E':
+                return 1e18;
+            case 'Z':
+                return 1e21;
+            case 'Y':
+                return 1e24;
+            default:
+                return 0.0;
+        }
+    }
+
+    /** constexpr recursive descent parser for simple unit strings
+    @details units are matched exactly against the defined unit strings in the
+    same order as unit_from_string, optionally with an SI prefix or a
+    trailing integer power, and combined with '*', '.', '/', '^', and
+    parentheses.  Operators are applied left to right*/
+    class unit_literal_parser {
+      public:
+        constexpr unit_literal_parser(const char* str, std::size_t len) :
+            str_(str), len_(len)
+        {
+        }
+        /// parse the full string
+        constexpr precise_unit parse()
+        {
+            auto result = expression();
+            if (pos_ != len_) {
+                failed_ = true;
+            }
+            return failed_ ? unitLiteralNotRecognized() : result;
+        }
+        /// check whether the full string can be parsed
+        constexpr bool recognized()
+        {
+            expression();
+            return !failed_ && pos_ == len_;
+        }
+
+      private:
+        /// mark the parse as failed, the error is raised at the end of parse
+        constexpr precise_unit fail()
+        {
+            failed_ = true;
+            return precise::error;
+        }
+        static constexpr bool isSeparator(char ch)
+        {
+            return ch == '*' || ch == '.' || ch == '/' || ch == '^' ||
+                ch == '(' || ch == ')';
+        }
+        static constexpr bool isDigit(char ch)
+        {
+            return ch >= '0' && ch <= '9';
+        }
+
+        /// expression := term (('*' | '.' | '/') term)*
+        constexpr precise_unit expression()
+        {
+            auto result = term();
+            while (!failed_ && pos_ < len_ &&
+                   (str_[pos_] == '*' || str_[pos_] == '.' ||
+                    str_[pos_] == '/')) {
+                const bool divide = (str_[pos_] == '/');
+                ++pos_;
+                auto next = term();
+                result = divide ? result / next : result * next;
+            }
+            return result;
+        }
+        /// term := factor ('^' integer)?
+        constexpr precise_unit term()
+        {
+            auto base = factor();
+            if (!failed_ && pos_ < len_ && str_[pos_] == '^') {
+                ++pos_;
+                int power{0};
+                if (!integer(power)) {
+                    return fail();
+                }
+                return base.pow(power);
+            }
+            return base;
+        }
+        /// factor := '(' expression ')' | symbol
+        constexpr precise_unit factor()
+        {
+            if (pos_ < len_ && str_[pos_] == '(') {
+                ++pos_;
+                auto inner = expression();
+                if (pos_ >= len_ || str_[pos_] != ')') {
+                    return fail();
+                }
+                ++pos_;
+                return inner;
+            }
+            auto start = pos_;
+            int depth{0};
+            while (pos_ < len_ && (depth > 0 || !isSeparator(str_[pos_]))) {
+                if (str_[pos_] == '[') {
+                    ++depth;
+                } else if (str_[pos_] == ']') {
+                    --depth;
+                }
+                ++pos_;
+            }
+            if (pos_ == start || depth != 0) {
+                return fail();
+            }
+            return symbol(start, pos_ - start);
+        }
+        /// read a signed integer power
+        constexpr bool integer(int& power)
+        {
+            bool negative{false};
+            if (pos_ < len_ && (str_[pos_] == '-' || str_[pos_] == '+')) {
+                negative = (str_[pos_] == '-');
+                ++pos_;
+            }
+            auto start = pos_;
+            while (pos_ < len_ && isDigit(str_[pos_])) {
+                power = power * 10 + (str_[pos_] - '0');
+                ++pos_;
+            }
+            if (negative) {
+                power = -power;
+            }
+            return pos_ > start;
+        }
+        /// compare a section of the string to a null terminated key
+        constexpr bool
+            matches(std::size_t start, std::size_t len, const char* key) const
+        {
+            for (std::size_t ii = 0; ii < len; ++ii) {
+                if (key[ii] != str_[start + ii]) {
+                    return false;
+                }
+            }
+            return key[len] == '\0';
+        }
+        /// look up a string in the defined unit strings
+        constexpr bool lookup(
+            std::size_t start,
+            std::size_t len,
+            precise_unit& result) const
+        {
+            for (std::size_t ii = 0; ii < defined_unit_strings_si.size();
+                 ++ii) {
+                if (matches(start, len, defined_unit_strings_si[ii].first)) {
+                    result = defined_unit_strings_si[ii].second;
+                    return true;
+                }
+            }
+            for (std::size_t ii = 0; ii < defined_unit_strings_customary.size();
+                 ++ii) {
+                if (matches(
+                        start, len, defined_unit_strings_customary[ii].first)) {
+                    result = defined_unit_strings_customary[ii].second;
+                    return true;
+                }
+            }
+            return false;
+        }
+        /// look up a unit string with an optional SI prefix
+        constexpr bool prefixedLookup(
+            std::size_t start,
+            std::size_t len,
+            precise_unit& result) const
+        {
+            if (lookup(start, len, result)) {
+                return true;
+            }
+            // UCUM bracketed units are defined without the brackets
+            if (len > 2 && str_[start] == '[' && str_[start + len - 1] == ']') {
+                return lookup(start + 1, len - 2, result);
+            }
+            if (len > 2 && str_[start] == 'd' && str_[start + 1] == 'a' &&
+                lookup(start + 2, len - 2, result)) {
+                result = precise_unit(10.0, result);
+                return true;
+            }
+            const double mult = literalPrefixMultiplier(str_[start]);
+            if (len > 1 && mult != 0.0 && lookup(start + 1, len - 1, result)) {
+                result = precise_unit(mult, result);
+                return true;
+            }
+            return false;
+        }
+        /// a unit string with an optional prefix and trailing integer power
+        constexpr precise_unit symbol(std::size_t start, std::size_t len)
+        {
+            precise_unit result;
+            if (prefixedLookup(start, len, result)) {
+                return result;
+            }
+            auto digits = len;
+            while (digits > 0 && isDigit(str_[start + digits - 1])) {
+                --digits;
+            }
+            if (digits == len || digits == 0) {
+                return fail();
+            }
+            auto power_start = digits;
+            if (str_[start + digits - 1] == '-' ||
+                str_[start + digits - 1] == '+') {
+                --digits;
+            }
+            if (digits == 0 || !prefixedLookup(start, digits, result)) {
+                return fail();
+            }
+            int power{0};
+            for (auto ii = power_start; ii < len; ++ii) {
+                power = power * 10 + (str_[start + ii] - '0');
+            }
+            if (str_[start + digits] == '-') {
+                power = -power;
+            }
+            return result.pow(power);
+        }
+
+        const char* str_;
+        std::size_t len_;
+        std::size_t pos_{0};
+        bool failed_{false};
+    };
+
+    /** the conversion behind UNITS_UNIT_LITERAL, recognition of the string is
+    a template argument so it is checked at compile time in every context*/
+    template<bool Recognized>
+    constexpr precise_unit unitLiteral(const char* str, std::size_t len)
+    {
+        static_assert(Recognized, "the unit string is not recognized");
+        return unit_literal_parser(str, len).parse();
+    }
+}  // namespace detail
+
+#ifdef UNITS_HAS_UNIT_LITERALS
+namespace literals {
+    /** convert a unit string to a precise_unit at compile time
+    @details the literal is consteval so a string it cannot interpret is
+    always a compile error*/
+    consteval precise_unit operator""_unit(const char* str, std::size_t len)
+    {
+        return detail::unit_literal_parser(str, len).parse();
+    }
+}  // namespace literals
+#endif
+
+}  // namespace UNITS_NAMESPACE
+
+/** convert a unit string literal to a precise_unit
+@details a string which cannot be interpreted is a compile error in every
+context, the value is computed at compile time when it initializes a
+constexpr variable*/
+#define UNITS_UNIT_LITERAL(str)                                                \
+    UNITS_NAMESPACE::detail::unitLiteral<                                      \
+        UNITS_NAMESPACE::detail::unit_literal_parser(str, sizeof(str) - 1)     \
+            .recognized()>(str, sizeof(str) - 1)
+
+#endif
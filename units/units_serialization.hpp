@@ -0,0 +1,579 @@
+/*
+Copyright (c) 2019-2022,
+Lawrence Livermore National Security, LLC;
+See the top-level NOTICE for additional details. All rights reserved.
+SPDX-License-Identifier: BSD-3-Clause
+*/
+#pragma once
+
+#include "units.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <type_traits>
+
+#ifdef UNITS_HAS_SPAN
+#include <cstddef>
+#endif
+
+/** @file
+Binary and compact ASCII encodings of units and measurements.
+
+The binary encoding of a value is a tag byte followed by the fields of the
+value, all stored little endian independent of the platform.  The low 4 bits
+of the tag identify the type, bit 4 is set if the unit_data bits are 64 bits
+instead of 32, and the upper 3 bits are a format version which is currently 0.
+The unit_data bits are packed in declaration order starting from the least
+significant bit with the exponents in two's complement.
+
+| type                      | fields after the tag                       |
+|---------------------------|--------------------------------------------|
+| unit                      | unit_data, float multiplier                |
+| precise_unit              | unit_data, uint32 commodity, double mult   |
+| measurement               | double value, unit                         |
+| precise_measurement       | double value, precise_unit                 |
+| uncertain_measurement     | float value, float uncertainty, unit       |
+| fixed_measurement         | double value, unit                         |
+| fixed_precise_measurement | double value, precise_unit                 |
+
+The ASCII encoding is the binary encoding in the base64url alphabet without
+padding.
+*/
+namespace UNITS_NAMESPACE {
+namespace detail {
+    namespace wire {
+        static_assert(
+            std::numeric_limits<float>::is_iec559 &&
+                std::numeric_limits<double>::is_iec559,
+            "the encodings require IEEE 754 floating point");
+
+        /// the number of bytes used for the unit_data bits
+        constexpr std::size_t base_bytes{bitwidth::base_size};
+
+        /// generate the tag byte for a type code
+        constexpr unsigned char tag(unsigned char code)
+        {
+            return static_cast<unsigned char>(
+                code | ((base_bytes == 8) ? 0x10U : 0x00U));
+        }
+
+        /// write the lowest `bytes` bytes of a value little endian
+        inline void putBytes(char* out, std::uint64_t val, std::size_t bytes)
+        {
+            for (std::size_t ii = 0; ii < bytes; ++ii) {
+                out[ii] = static_cast<char>(
+                    static_cast<unsigned char>((val >> (8U * ii)) & 0xFFU));
+            }
+        }
+
+        /// read a little endian value of `bytes` bytes
+        inline std::uint64_t getBytes(const char* in, std::size_t bytes)
+        {
+            std::uint64_t val{0};
+            for (std::size_t ii = 0; ii < bytes; ++ii) {
+                val |= static_cast<std::uint64_t>(
+                           static_cast<unsigned char>(in[ii]))
+                    << (8U * ii);
+            }
+            return val;
+        }
+
+        inline void putFloat(char* out, float val)
+        {
+            std::uint32_t bits;
+            std::memcpy(&bits, &val, sizeof(bits));
+            putBytes(out, bits, 4);
+        }
+
+        inline float getFloat(const char* in)
+        {
+            auto bits = static_cast<std::uint32_t>(getBytes(in, 4));
+            float val;
+            std::memcpy(&val, &bits, sizeof(val));
+            return val;
+        }
+
+        inline void putDouble(char* out, double val)
+        {
+            std::uint64_t bits;
+            std::memcpy(&bits, &val, sizeof(bits));
+            putBytes(out, bits, 8);
+        }
+
+        inline double getDouble(const char* in)
+        {
+            std::uint64_t bits = getBytes(in, 8);
+            double val;
+            std::memcpy(&val, &bits, sizeof(val));
+            return val;
+        }
+
+        /// packs the unit_data fields into an integer in declaration order
+        class base_packer {
+          public:
+            void push(int val, std::uint32_t width)
+            {
+                word_ |= (static_cast<std::uint64_t>(
+                              static_cast<std::uint32_t>(val)) &
+                          ((std::uint64_t{1} << width) - 1U))
+                    << shift_;
+                shift_ += width;
+            }
+            void push(bool flag) { push(flag ? 1 : 0, 1U); }
+            std::uint64_t word() const { return word_; }
+
+          private:
+            std::uint64_t word_{0};
+            std::uint32_t shift_{0};
+        };
+
+        /// extracts the unit_data fields from an integer in declaration order
+        class base_unpacker {
+          public:
+            explicit base_unpacker(std::uint64_t word) : word_(word) {}
+            int pop(std::uint32_t width)
+            {
+                auto val = static_cast<std::int64_t>(
+                    (word_ >> shift_) & ((std::uint64_t{1} << width) - 1U));
+                shift_ += width;
+                // sign extend the two's complement field
+                return static_cast<int>(
+                    (val >= (std::int64_t{1} << (width - 1U))) ?
+                        val - (std::int64_t{1} << width) :
+                        val);
+            }
+            unsigned int flag()
+            {
+                auto val = static_cast<unsigned int>((word_ >> shift_) & 1U);
+                ++shift_;
+                return val;
+            }
+
+          private:
+            std::uint64_t word_;
+            std::uint32_t shift_{0};
+        };
+
+        inline void putBase(char* out, const unit_data& base)
+        {
+            base_packer packer;
+            packer.push(base.meter(), bitwidth::meter);
+            packer.push(base.second(), bitwidth::second);
+            packer.push(base.kg(), bitwidth::kilogram);
+            packer.push(base.ampere(), bitwidth::ampere);
+            packer.push(base.candela(), bitwidth::candela);
+            packer.push(base.kelvin(), bitwidth::kelvin);
+            packer.push(base.mole(), bitwidth::mole);
+            packer.push(base.radian(), bitwidth::radian);
+            packer.push(base.currency(), bitwidth::currency);
+            packer.push(base.count(), bitwidth::count);
+            packer.push(base.is_per_unit());
+            packer.push(base.has_i_flag());
+            packer.push(base.has_e_flag());
+            packer.push(base.is_equation());
+            putBytes(out, packer.word(), base_bytes);
+        }
+
+        inline unit_data getBase(const char* in)
+        {
+            base_unpacker unpacker(getBytes(in, base_bytes));
+            const int meters = unpacker.pop(bitwidth::meter);
+            const int seconds = unpacker.pop(bitwidth::second);
+            const int kilograms = unpacker.pop(bitwidth::kilogram);
+            const int amperes = unpacker.pop(bitwidth::ampere);
+            const int candelas = unpacker.pop(bitwidth::candela);
+            const int kelvins = unpacker.pop(bitwidth::kelvin);
+            const int moles = unpacker.pop(bitwidth::mole);
+            const int radians = unpacker.pop(bitwidth::radian);
+            const int currencys = unpacker.pop(bitwidth::currency);
+            const int counts = unpacker.pop(bitwidth::count);
+            const unsigned int per_unit = unpacker.flag();
+            const unsigned int i_flag = unpacker.flag();
+            const unsigned int e_flag = unpacker.flag();
+            const unsigned int equation = unpacker.flag();
+            return {
+                meters,
+                kilograms,
+                seconds,
+                amperes,
+                kelvins,
+                moles,
+                candelas,
+                currencys,
+                counts,
+                radians,
+                per_unit,
+                i_flag,
+                e_flag,
+                equation};
+        }
+
+        /// the type code, field size, and field conversions for each type
+        template<class X>
+        struct traits {
+            static constexpr bool supported = false;
+        };
+
+        template<>
+        struct traits<unit> {
+            static constexpr bool supported = true;
+            static constexpr unsigned char code = 1;
+            static constexpr std::size_t size = base_bytes + 4;
+            static void write(char* out, const unit& val)
+            {
+                putBase(out, val.base_units());
+                putFloat(out + base_bytes, val.multiplier_f());
+            }
+            static unit read(const char* in)
+            {
+                return unit{getBase(in), getFloat(in + base_bytes)};
+            }
+            static unit invalid() { return UNITS_NAMESPACE::invalid; }
+        };
+
+        template<>
+        struct traits<precise_unit> {
+            static constexpr bool supported = true;
+            static constexpr unsigned char code = 2;
+            static constexpr std::size_t size = base_bytes + 12;
+            static void write(char* out, const precise_unit& val)
+            {
+                putBase(out, val.base_units());
+                putBytes(out + base_bytes, val.commodity(), 4);
+                putDouble(out + base_bytes + 4, val.multiplier());
+            }
+            static precise_unit read(const char* in)
+            {
+                return {
+                    getBase(in),
+                    static_cast<std::uint32_t>(getBytes(in + base_bytes, 4)),
+                    getDouble(in + base_bytes + 4)};
+            }
+            static precise_unit invalid() { return precise::invalid; }
+        };
+
+        /// shared layout of the measurement types with a double value
+        template<class X, class U, unsigned char Code>
+        struct measurement_traits {
+            static constexpr bool supported = true;
+            static constexpr unsigned char code = Code;
+            static constexpr std::size_t size = 8 + traits<U>::size;
+            static void write(char* out, const X& val)
+            {
+                putDouble(out, val.value());
+                traits<U>::write(out + 8, val.units());
+            }
+            static X read(const char* in)
+            {
+                return {getDouble(in), traits<U>::read(in + 8)};
+            }
+            static X invalid()
+            {
+                return {constants::invalid_conversion, traits<U>::invalid()};
+            }
+        };
+
+        template<>
+        struct traits<measurement> :
+            measurement_traits<measurement, unit, 3> {};
+        template<>
+        struct traits<precise_measurement> :
+            measurement_traits<precise_measurement, precise_unit, 4> {};
+        template<>
+        struct traits<fixed_measurement> :
+            measurement_traits<fixed_measurement, unit, 6> {};
+        template<>
+        struct traits<fixed_precise_measurement> :
+            measurement_traits<
+                fixed_precise_measurement,
+                precise_unit,
+                7> {};
+
+        template<>
+        struct traits<uncertain_measurement> {
+            static constexpr bool supported = true;
+            static constexpr unsigned char code = 5;
+            static constexpr std::size_t size = 8 + traits<unit>::size;
+            static void write(char* out, const uncertain_measurement& val)
+            {
+                putFloat(out, val.value_f());
+                putFloat(out + 4, val.uncertainty_f());
+                traits<unit>::write(out + 8, val.units());
+            }
+            static uncertain_measurement read(const char* in)
+            {
+                return {
+                    getFloat(in), getFloat(in + 4), traits<unit>::read(in + 8)};
+            }
+            static uncertain_measurement invalid()
+            {
+                return {
+                    static_cast<float>(constants::invalid_conversion),
+                    static_cast<float>(constants::invalid_conversion),
+                    UNITS_NAMESPACE::invalid};
+            }
+        };
+
+        /// the return type R if X has an encoding
+        template<class X, class R>
+        using if_encodable =
+            typename std::enable_if<traits<X>::supported, R>::type;
+
+        /// write bytes as base64url characters without padding
+        inline void base64Encode(const char* in, std::size_t bytes, char* out)
+        {
+            const char* alphabet =
+                "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz"
+                "0123456789-_";
+            std::size_t ii = 0;
+            for (; ii + 3 <= bytes; ii += 3) {
+                auto group = static_cast<std::uint32_t>(getBytes(in + ii, 1)
+                                                        << 16U) |
+                    static_cast<std::uint32_t>(getBytes(in + ii + 1, 1) << 8U) |
+                    static_cast<std::uint32_t>(getBytes(in + ii + 2, 1));
+                *out++ = alphabet[(group >> 18U) & 0x3FU];
+                *out++ = alphabet[(group >> 12U) & 0x3FU];
+                *out++ = alphabet[(group >> 6U) & 0x3FU];
+                *out++ = alphabet[group & 0x3FU];
+            }
+            if (ii < bytes) {
+                auto group =
+                    static_cast<std::uint32_t>(getBytes(in + ii, 1) << 16U);
+                if (ii + 1 < bytes) {
+                    group |= static_cast<std::uint32_t>(
+                        getBytes(in + ii + 1, 1) << 8U);
+                }
+                *out++ = alphabet[(group >> 18U) & 0x3FU];
+                *out++ = alphabet[(group >> 12U) & 0x3FU];
+                if (ii + 1 < bytes) {
+                    *out++ = alphabet[(group >> 6U) & 0x3FU];
+                }
+            }
+        }
+
+        constexpr int base64Value(char chr)
+        {
+            return (chr >= 'A' && chr <= 'Z') ? chr - 'A' :
+                (chr >= 'a' && chr <= 'z')    ? chr - 'a' + 26 :
+                (chr >= '0' && chr <= '9')    ? chr - '0' + 52 :
+                (chr == '-')                  ? 62 :
+                (chr == '_')                  ? 63 :
+                                                -1;
+        }
+
+        /** read base64url characters into bytes
+        @return false if a character is not in the alphabet or the unused bits
+        of the last character are not zero*/
+        inline bool base64Decode(const char* in, std::size_t bytes, char* out)
+        {
+            std::uint32_t group{0};
+            std::uint32_t bits{0};
+            std::size_t written{0};
+            while (written < bytes) {
+                const int val = base64Value(*in++);
+                if (val < 0) {
+                    return false;
+                }
+                group = (group << 6U) | static_cast<std::uint32_t>(val);
+                bits += 6;
+                if (bits >= 8) {
+                    bits -= 8;
+                    out[written++] = static_cast<char>(
+                        static_cast<unsigned char>((group >> bits) & 0xFFU));
+                }
+            }
+            // the encoding is canonical so any leftover bits must be zero
+            return (group & ((1U << bits) - 1U)) == 0U;
+        }
+
+    }  // namespace wire
+}  // namespace detail
+
+/// the number of bytes in the binary encoding of a unit or measurement type
+template<class X>
+constexpr detail::wire::if_encodable<X, std::size_t> binary_size()
+{
+    return detail::wire::traits<X>::size + 1;
+}
+
+/// the number of characters in the ASCII encoding of a unit or measurement type
+template<class X>
+constexpr detail::wire::if_encodable<X, std::size_t> ascii_size()
+{
+    return (binary_size<X>() * 4 + 2) / 3;
+}
+
+/** Write the binary encoding of a unit or measurement into a buffer
+@param val the unit or measurement to encode
+@param buffer the buffer to write into
+@param size the number of bytes available in the buffer
+@return the number of bytes written, 0 if the buffer was too small
+*/
+template<class X>
+detail::wire::if_encodable<X, std::size_t>
+    to_binary(const X& val, char* buffer, std::size_t size) noexcept
+{
+    using traits = detail::wire::traits<X>;
+    if (size < binary_size<X>()) {
+        return 0;
+    }
+    buffer[0] = static_cast<char>(detail::wire::tag(traits::code));
+    traits::write(buffer + 1, val);
+    return binary_size<X>();
+}
+
+/// Generate a string containing the binary encoding of a unit or measurement
+template<class X>
+detail::wire::if_encodable<X, std::string>
+    to_binary(const X& val)
+{
+    std::string result(binary_size<X>(), '\0');
+    to_binary(val, &result[0], result.size());
+    return result;
+}
+
+/** Read a unit or measurement from its binary encoding
+@details the encoding is read from the start of the buffer and any bytes past
+binary_size<X>() are ignored so records can be read in sequence
+@param buffer the buffer containing the encoding
+@param size the number of bytes in the buffer
+@return the decoded value, or an invalid unit or measurement if the buffer is
+too short or does not contain an encoding of the requested type
+*/
+template<class X>
+detail::wire::if_encodable<X, X>
+    from_binary(const char* buffer, std::size_t size) noexcept
+{
+    using traits = detail::wire::traits<X>;
+    if (size < binary_size<X>() ||
+        static_cast<unsigned char>(buffer[0]) !=
+            detail::wire::tag(traits::code)) {
+        return traits::invalid();
+    }
+    return traits::read(buffer + 1);
+}
+
+/** Write the ASCII encoding of a unit or measurement into a buffer
+@param val the unit or measurement to encode
+@param buffer the buffer to write into, no null terminator is written
+@param size the number of characters available in the buffer
+@return the number of characters written, 0 if the buffer was too small
+*/
+template<class X>
+detail::wire::if_encodable<X, std::size_t>
+    to_ascii(const X& val, char* buffer, std::size_t size) noexcept
+{
+    if (size < ascii_size<X>()) {
+        return 0;
+    }
+    char bytes[detail::wire::traits<X>::size + 1];
+    to_binary(val, bytes, sizeof(bytes));
+    detail::wire::base64Encode(bytes, sizeof(bytes), buffer);
+    return ascii_size<X>();
+}
+
+/// Generate a string containing the ASCII encoding of a unit or measurement
+template<class X>
+detail::wire::if_encodable<X, std::string>
+    to_ascii(const X& val)
+{
+    std::string result(ascii_size<X>(), '\0');
+    to_ascii(val, &result[0], result.size());
+    return result;
+}
+
+/** Read a unit or measurement from its ASCII encoding
+@details the encoding is read from the start of the buffer and any characters
+past ascii_size<X>() are ignored
+@param buffer the characters containing the encoding
+@param size the number of characters in the buffer
+@return the decoded value, or an invalid unit or measurement if the characters
+are not a valid encoding of the requested type
+*/
+template<class X>
+detail::wire::if_encodable<X, X>
+    from_ascii(const char* buffer, std::size_t size) noexcept
+{
+    char bytes[detail::wire::traits<X>::size + 1];
+    if (size < ascii_size<X>() ||
+        !detail::wire::base64Decode(buffer, sizeof(bytes), bytes)) {
+        return detail::wire::traits<X>::invalid();
+    }
+    return from_binary<X>(bytes, sizeof(bytes));
+}
+
+#ifdef UNITS_HAS_STRING_VIEW
+/// Read a unit or measurement from a string_view containing its binary encoding
+template<class X>
+detail::wire::if_encodable<X, X>
+    from_binary(std::string_view data) noexcept
+{
+    return from_binary<X>(data.data(), data.size());
+}
+
+/// Read a unit or measurement from a string_view containing its ASCII encoding
+template<class X>
+detail::wire::if_encodable<X, X>
+    from_ascii(std::string_view data) noexcept
+{
+    return from_ascii<X>(data.data(), data.size());
+}
+#else
+/// Read a unit or measurement from a string containing its binary encoding
+template<class X>
+detail::wire::if_encodable<X, X>
+    from_binary(const std::string& data) noexcept
+{
+    return from_binary<X>(data.data(), data.size());
+}
+
+/// Read a unit or measurement from a string containing its ASCII encoding
+template<class X>
+detail::wire::if_encodable<X, X>
+    from_ascii(const std::string& data) noexcept
+{
+    return from_ascii<X>(data.data(), data.size());
+}
+#endif
+
+#ifdef UNITS_HAS_SPAN
+/// Write the binary encoding of a unit or measurement into a span
+template<class X>
+detail::wire::if_encodable<X, std::size_t>
+    to_binary(const X& val, std::span<std::byte> buffer) noexcept
+{
+    return to_binary(
+        val, reinterpret_cast<char*>(buffer.data()), buffer.size());
+}
+
+/// Read a unit or measurement from a span containing its binary encoding
+template<class X>
+detail::wire::if_encodable<X, X>
+    from_binary(std::span<const std::byte> buffer) noexcept
+{
+    return from_binary<X>(
+        reinterpret_cast<const char*>(buffer.data()), buffer.size());
+}
+
+/// Write the ASCII encoding of a unit or measurement into a span
+template<class X>
+detail::wire::if_encodable<X, std::size_t>
+    to_ascii(const X& val, std::span<std::byte> buffer) noexcept
+{
+    return to_ascii(
+        val, reinterpret_cast<char*>(buffer.data()), buffer.size());
+}
+
+/// Read a unit or measurement from a span containing its ASCII encoding
+template<class X>
+detail::wire::if_encodable<X, X>
+    from_ascii(std::span<const std::byte> buffer) noexcept
+{
+    return from_ascii<X>(
+        reinterpret_cast<const char*>(buffer.data()), buffer.size());
+}
+#endif
+
+}  // namespace UNITS_NAMESPACE
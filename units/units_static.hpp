@@ -0,0 +1,392 @@
+/*
+Copyright (c) 2019-2022,
+Lawrence Livermore National Security, LLC;
+See the top-level NOTICE for additional details. All rights reserved.
+SPDX-License-Identifier: BSD-3-Clause
+*/
+#pragma once
+
+#include "units.hpp"
+
+#include <cstdint>
+#include <ratio>
+#include <type_traits>
+
+/** @file
+measurements with the unit encoded in the type, the unit_data is packed into
+an integer template parameter and the multiplier is a std::ratio
+*/
+
+namespace UNITS_NAMESPACE {
+namespace detail {
+    /// the integer holding a packed unit_data
+    using packed_unit_data = std::uint64_t;
+
+    constexpr packed_unit_data
+        packField(int value, std::uint32_t width, std::uint32_t shift)
+    {
+        return (static_cast<packed_unit_data>(
+                    static_cast<std::uint32_t>(value)) &
+                ((packed_unit_data{1} << width) - 1U))
+            << shift;
+    }
+
+    constexpr int unpackField(
+        packed_unit_data packed,
+        std::uint32_t width,
+        std::uint32_t shift)
+    {
+        return (((packed >> shift) & ((packed_unit_data{1} << width) - 1U)) >=
+                (packed_unit_data{1} << (width - 1U))) ?
+            static_cast<int>((packed >> shift) &
+                             ((packed_unit_data{1} << width) - 1U)) -
+                static_cast<int>(1U << width) :
+            static_cast<int>(
+                (packed >> shift) & ((packed_unit_data{1} << width) - 1U));
+    }
+
+    /// the bit offsets of the fields in a packed unit_data
+    namespace packed_offset {
+        constexpr std::uint32_t meter{0};
+        constexpr std::uint32_t second{meter + bitwidth::meter};
+        constexpr std::uint32_t kilogram{second + bitwidth::second};
+        constexpr std::uint32_t ampere{kilogram + bitwidth::kilogram};
+        constexpr std::uint32_t candela{ampere + bitwidth::ampere};
+        constexpr std::uint32_t kelvin{candela + bitwidth::candela};
+        constexpr std::uint32_t mole{kelvin + bitwidth::kelvin};
+        constexpr std::uint32_t radian{mole + bitwidth::mole};
+        constexpr std::uint32_t currency{radian + bitwidth::radian};
+        constexpr std::uint32_t count{currency + bitwidth::currency};
+        constexpr std::uint32_t flags{count + bitwidth::count};
+    }  // namespace packed_offset
+
+    /// pack a unit_data into an integer usable as a template parameter
+    constexpr packed_unit_data packUnitData(const unit_data& ud)
+    {
+        return packField(ud.meter(), bitwidth::meter, packed_offset::meter) |
+            packField(ud.second(), bitwidth::second, packed_offset::second) |
+            packField(ud.kg(), bitwidth::kilogram, packed_offset::kilogram) |
+            packField(ud.ampere(), bitwidth::ampere, packed_offset::ampere) |
+            packField(ud.candela(), bitwidth::candela, packed_offset::candela) |
+            packField(ud.kelvin(), bitwidth::kelvin, packed_offset::kelvin) |
+            packField(ud.mole(), bitwidth::mole, packed_offset::mole) |
+            packField(ud.radian(), bitwidth::radian, packed_offset::radian) |
+            packField(
+                   ud.currency(), bitwidth::currency, packed_offset::currency) |
+            packField(ud.count(), bitwidth::count, packed_offset::count) |
+            packField(ud.is_per_unit() ? 1 : 0, 1, packed_offset::flags) |
+            packField(ud.has_i_flag() ? 1 : 0, 1, packed_offset::flags + 1) |
+            packField(ud.has_e_flag() ? 1 : 0, 1, packed_offset::flags + 2) |
+            packField(ud.is_equation() ? 1 : 0, 1, packed_offset::flags + 3);
+    }
+
+    /// recover a unit_data from its packed form
+    constexpr unit_data unpackUnitData(packed_unit_data packed)
+    {
+        return {
+            unpackField(packed, bitwidth::meter, packed_offset::meter),
+            unpackField(packed, bitwidth::kilogram, packed_offset::kilogram),
+            unpackField(packed, bitwidth::second, packed_offset::second),
+            unpackField(packed, bitwidth::ampere, packed_offset::ampere),
+            unpackField(packed, bitwidth::kelvin, packed_offset::kelvin),
+            unpackField(packed, bitwidth::mole, packed_offset::mole),
+            unpackField(packed, bitwidth::candela, packed_offset::candela),
+            unpackField(packed, bitwidth::currency, packed_offset::currency),
+            unpackField(packed, bitwidth::count, packed_offset::count),
+            unpackField(packed, bitwidth::radian, packed_offset::radian),
+            static_cast<unsigned int>((packed >> packed_offset::flags) & 1U),
+            static_cast<unsigned int>(
+                (packed >> (packed_offset::flags + 1)) & 1U),
+            static_cast<unsigned int>(
+                (packed >> (packed_offset::flags + 2)) & 1U),
+            static_cast<unsigned int>(
+                (packed >> (packed_offset::flags + 3)) & 1U)};
+    }
+}  // namespace detail
+
+/** A unit known at compile time
+@tparam Base the unit_data of the unit packed with detail::packUnitData
+@tparam Scale the multiplier of the unit as a std::ratio*/
+template<detail::packed_unit_data Base, class Scale = std::ratio<1>>
+struct static_unit {
+    static_assert(Scale::num > 0, "static unit multipliers must be positive");
+    /// the multiplier of the unit as a std::ratio
+    using scale = Scale;
+    /// the packed unit_data
+    static constexpr detail::packed_unit_data packed_base = Base;
+
+    /// Get the base units
+    static constexpr detail::unit_data base_units()
+    {
+        return detail::unpackUnitData(Base);
+    }
+    /// Get the multiplier of the unit
+    static constexpr double multiplier()
+    {
+        return static_cast<double>(Scale::num) /
+            static_cast<double>(Scale::den);
+    }
+    /// Get the unit as a precise_unit
+    static constexpr precise_unit value()
+    {
+        return {base_units(), multiplier()};
+    }
+};
+
+/// The static unit of the product of two static units
+template<class U1, class U2>
+using static_unit_multiply = static_unit<
+    detail::packUnitData(U1::base_units() * U2::base_units()),
+    std::ratio_multiply<typename U1::scale, typename U2::scale>>;
+
+/// The static unit of the quotient of two static units
+template<class U1, class U2>
+using static_unit_divide = static_unit<
+    detail::packUnitData(U1::base_units() / U2::base_units()),
+    std::ratio_divide<typename U1::scale, typename U2::scale>>;
+
+/// The inverse of a static unit
+template<class U>
+using static_unit_inverse = static_unit<
+    detail::packUnitData(U::base_units().inv()),
+    std::ratio_divide<std::ratio<1>, typename U::scale>>;
+
+/// A static unit with a different multiplier
+template<class U, class Scale>
+using static_unit_scale = static_unit<
+    U::packed_base,
+    std::ratio_multiply<typename U::scale, Scale>>;
+
+namespace detail {
+    /** check if values of static unit U1 can be converted to U2 with a
+    constant factor, temperatures and other flagged units are excluded since
+    their conversions are not linear*/
+    template<class U1, class U2>
+    struct static_convertible :
+        std::integral_constant<
+            bool,
+            U1::packed_base == U2::packed_base &&
+                !U1::base_units().has_e_flag() &&
+                !U1::base_units().is_equation()> {
+    };
+
+    /// the factor converting values of static unit U1 to U2
+    template<class U1, class U2>
+    constexpr double staticConversionFactor()
+    {
+        return static_cast<double>(
+                   std::ratio_divide<typename U1::scale, typename U2::scale>::
+                       num) /
+            static_cast<double>(
+                   std::ratio_divide<typename U1::scale, typename U2::scale>::
+                       den);
+    }
+}  // namespace detail
+
+/** A measurement with the unit encoded in the type
+@details the object holds only a double, arithmetic compiles to operations on
+the values with the units resolved at compile time.  Measurements convert
+implicitly to and from precise_measurement and measurement, and between static
+units of the same dimension with a constant factor*/
+template<class U>
+class static_measurement {
+  public:
+    /// the static unit of the measurement
+    using unit_type = U;
+
+    /// construct with a value of 0
+    constexpr static_measurement() noexcept = default;
+    /// construct from a value in the static unit
+    explicit constexpr static_measurement(double val) noexcept : value_(val)
+    {
+    }
+    /// convert from a static measurement of the same dimension
+    template<
+        class U2,
+        typename = typename std::enable_if<
+            detail::static_convertible<U2, U>::value>::type>
+    // NOLINTNEXTLINE(google-explicit-constructor)
+    constexpr static_measurement(const static_measurement<U2>& other) noexcept :
+        value_(other.value() * detail::staticConversionFactor<U2, U>())
+    {
+    }
+    /// convert from a precise_measurement, NaN if the units are not compatible
+    // NOLINTNEXTLINE(google-explicit-constructor)
+    static_measurement(const precise_measurement& other) :
+        value_(other.value_as(U::value()))
+    {
+    }
+    /// convert from a measurement, NaN if the units are not compatible
+    // NOLINTNEXTLINE(google-explicit-constructor)
+    static_measurement(const measurement& other) :
+        value_(convert(other.value(), other.units(), U::value()))
+    {
+    }
+
+    /// Get the numerical value in the static unit
+    constexpr double value() const { return value_; }
+    /// Get the unit as a precise_unit
+    static constexpr precise_unit units() { return U::value(); }
+    /// Get the value in another static unit of the same dimension
+    template<class U2>
+    constexpr double value_as() const
+    {
+        static_assert(
+            detail::static_convertible<U, U2>::value,
+            "static units must have the same dimension");
+        return value_ * detail::staticConversionFactor<U, U2>();
+    }
+    /// Get the value in a dynamic unit
+    double value_as(const precise_unit& desired_units) const
+    {
+        return convert(value_, U::value(), desired_units);
+    }
+    /// Convert to another static unit of the same dimension
+    template<class U2>
+    constexpr static_measurement<U2> convert_to() const
+    {
+        return static_measurement<U2>(value_as<U2>());
+    }
+
+    /// convert to a precise_measurement
+    // NOLINTNEXTLINE(google-explicit-constructor)
+    operator precise_measurement() const { return {value_, U::value()}; }
+    /// convert to a measurement
+    // NOLINTNEXTLINE(google-explicit-constructor)
+    operator measurement() const { return {value_, unit_cast(U::value())}; }
+
+    constexpr static_measurement
+        operator+(const static_measurement& other) const
+    {
+        return static_measurement(value_ + other.value_);
+    }
+    constexpr static_measurement
+        operator-(const static_measurement& other) const
+    {
+        return static_measurement(value_ - other.value_);
+    }
+    constexpr static_measurement operator-() const
+    {
+        return static_measurement(-value_);
+    }
+    constexpr static_measurement operator*(double val) const
+    {
+        return static_measurement(value_ * val);
+    }
+    constexpr static_measurement operator/(double val) const
+    {
+        return static_measurement(value_ / val);
+    }
+    template<class U2>
+    constexpr static_measurement<static_unit_multiply<U, U2>>
+        operator*(const static_measurement<U2>& other) const
+    {
+        return static_measurement<static_unit_multiply<U, U2>>(
+            value_ * other.value());
+    }
+    template<class U2>
+    constexpr static_measurement<static_unit_divide<U, U2>>
+        operator/(const static_measurement<U2>& other) const
+    {
+        return static_measurement<static_unit_divide<U, U2>>(
+            value_ / other.value());
+    }
+    friend constexpr static_measurement
+        operator*(double val, const static_measurement& meas)
+    {
+        return static_measurement(val * meas.value_);
+    }
+    friend constexpr static_measurement<static_unit_inverse<U>>
+        operator/(double val, const static_measurement& meas)
+    {
+        return static_measurement<static_unit_inverse<U>>(val / meas.value_);
+    }
+
+    static_measurement& operator+=(const static_measurement& other)
+    {
+        value_ += other.value_;
+        return *this;
+    }
+    static_measurement& operator-=(const static_measurement& other)
+    {
+        value_ -= other.value_;
+        return *this;
+    }
+    static_measurement& operator*=(double val)
+    {
+        value_ *= val;
+        return *this;
+    }
+    static_measurement& operator/=(double val)
+    {
+        value_ /= val;
+        return *this;
+    }
+
+    /// comparisons are made directly on the values
+    constexpr bool operator==(const static_measurement& other) const
+    {
+        return value_ == other.value_;
+    }
+    constexpr bool operator!=(const static_measurement& other) const
+    {
+        return value_ != other.value_;
+    }
+    constexpr bool operator<(const static_measurement& other) const
+    {
+        return value_ < other.value_;
+    }
+    constexpr bool operator>(const static_measurement& other) const
+    {
+        return value_ > other.value_;
+    }
+    constexpr bool operator<=(const static_measurement& other) const
+    {
+        return value_ <= other.value_;
+    }
+    constexpr bool operator>=(const static_measurement& other) const
+    {
+        return value_ >= other.value_;
+    }
+
+  private:
+    double value_{0.0};
+};
+
+/// static units for common SI and customary units
+namespace static_units {
+    using one = static_unit<detail::packUnitData(precise::one.base_units())>;
+    using m = static_unit<detail::packUnitData(precise::m.base_units())>;
+    using kg = static_unit<detail::packUnitData(precise::kg.base_units())>;
+    using s = static_unit<detail::packUnitData(precise::s.base_units())>;
+    using A = static_unit<detail::packUnitData(precise::A.base_units())>;
+    using K = static_unit<detail::packUnitData(precise::K.base_units())>;
+    using mol = static_unit<detail::packUnitData(precise::mol.base_units())>;
+    using cd = static_unit<detail::packUnitData(precise::cd.base_units())>;
+    using rad = static_unit<detail::packUnitData(precise::rad.base_units())>;
+
+    using km = static_unit_scale<m, std::kilo>;
+    using cm = static_unit_scale<m, std::centi>;
+    using mm = static_unit_scale<m, std::milli>;
+    using g = static_unit_scale<kg, std::milli>;
+    using min = static_unit_scale<s, std::ratio<60>>;
+    using hr = static_unit_scale<s, std::ratio<3600>>;
+    using ms = static_unit_scale<s, std::milli>;
+    using in = static_unit_scale<m, std::ratio<254, 10000>>;
+    using ft = static_unit_scale<m, std::ratio<3048, 10000>>;
+    using yd = static_unit_scale<m, std::ratio<9144, 10000>>;
+    using mile = static_unit_scale<m, std::ratio<1609344, 1000>>;
+    using lb = static_unit_scale<kg, std::ratio<45359237, 100000000>>;
+
+    using Hz = static_unit_inverse<s>;
+    using mps = static_unit_divide<m, s>;
+    using N = static_unit_divide<static_unit_multiply<kg, m>,
+                                 static_unit_multiply<s, s>>;
+    using J = static_unit_multiply<N, m>;
+    using W = static_unit_divide<J, s>;
+    using kW = static_unit_scale<W, std::kilo>;
+    using Pa = static_unit_divide<N, static_unit_multiply<m, m>>;
+    using V = static_unit_divide<W, A>;
+}  // namespace static_units
+
+}  // namespace UNITS_NAMESPACE
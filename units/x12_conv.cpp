@@ -4,15 +4,12 @@ Lawrence Livermore National Security, LLC;
 See the top-level NOTICE for additional details. All rights reserved.
 SPDX-License-Identifier: BSD-3-Clause
 */
+#include "code_tables.hpp"
 #include "units.hpp"
 
-#include <algorithm>
 #include <array>
-#include <cstring>
-#include <tuple>
 
 namespace UNITS_NAMESPACE {
-using unitD = std::tuple<const char*, const char*, precise_unit>;
 static UNITS_CPP14_CONSTEXPR_OBJECT std::array<unitD, 486> x12_units{{
     unitD{"03", "SECOND", precise::s},
     unitD{"05", "LIFT", precise::one},
@@ -1015,32 +1012,24 @@ static UNITS_CPP14_CONSTEXPR_OBJECT std::array<unitD, 486> dod_units = {{
 
 precise_unit x12_unit(const std::string& x12_string)
 {
-    auto ind = std::lower_bound(
-        x12_units.begin(),
-        x12_units.end(),
-        x12_string,
-        [](const unitD& u_set, const std::string& val) {
-            return (strcmp(std::get<0>(u_set), val.c_str()) < 0);
-        });
-    if (strcmp(std::get<0>(*ind), x12_string.c_str()) == 0) {
-        return std::get<2>(*ind);
-    }
-    return precise::error;
+    return detail::findCodeUnit(
+        x12_units, x12_string.c_str(), x12_string.size());
+}
+
+precise_unit x12_unit(const char* x12_string, std::size_t length)
+{
+    return detail::findCodeUnit(x12_units, x12_string, length);
 }
 
 precise_unit dod_unit(const std::string& dod_string)
 {
-    auto ind = std::lower_bound(
-        dod_units.begin(),
-        dod_units.end(),
-        dod_string,
-        [](const unitD& u_set, const std::string& val) {
-            return (strcmp(std::get<0>(u_set), val.c_str()) < 0);
-        });
-    if (strcmp(std::get<0>(*ind), dod_string.c_str()) == 0) {
-        return std::get<2>(*ind);
-    }
-    return precise::error;
+    return detail::findCodeUnit(
+        dod_units, dod_string.c_str(), dod_string.size());
+}
+
+precise_unit dod_unit(const char* dod_string, std::size_t length)
+{
+    return detail::findCodeUnit(dod_units, dod_string, length);
 }
 
 }  // namespace UNITS_NAMESPACE